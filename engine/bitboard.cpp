@@ -0,0 +1,154 @@
+#include "bitboard.h"
+
+Bitboard knightAttacks[64];
+Bitboard kingAttacks[64];
+Bitboard pawnAttacks[2][64];
+Bitboard betweenSquares[64][64];
+Bitboard lineThrough[64][64];
+
+Magic rookMagics[64];
+Magic bishopMagics[64];
+static Bitboard rookAttackTable[0x19000];  // Sum over squares of 2^popCount(rook mask)
+static Bitboard bishopAttackTable[0x1480]; // Sum over squares of 2^popCount(bishop mask)
+
+static const int ROOK_DIRECTIONS[4][2] = { {0, 1}, {0, -1}, {1, 0}, {-1, 0} };
+static const int BISHOP_DIRECTIONS[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+// Set of squares reached by single steps from a square
+static Bitboard stepAttacks(int square, const int steps[][2], int stepCount) {
+    Bitboard attacks = 0;
+    int row = square / 8, col = square % 8;
+    for (int i = 0; i < stepCount; i++) {
+        int newRow = row + steps[i][0];
+        int newCol = col + steps[i][1];
+        if (isValidSquare(newRow, newCol)) {
+            attacks |= squareBit(squareOf(newRow, newCol));
+        }
+    }
+    return attacks;
+}
+
+// Walk sliding rays from a square until each one hits a piece in occupied
+static Bitboard slidingAttacks(int square, Bitboard occupied, const int directions[4][2]) {
+    Bitboard attacks = 0;
+    int row = square / 8, col = square % 8;
+    for (int d = 0; d < 4; d++) {
+        for (int i = 1; i < 8; i++) {
+            int newRow = row + i * directions[d][0];
+            int newCol = col + i * directions[d][1];
+            if (!isValidSquare(newRow, newCol)) break;
+
+            Bitboard bit = squareBit(squareOf(newRow, newCol));
+            attacks |= bit;
+            if (occupied & bit) break; // Blocked by a piece of either color
+        }
+    }
+    return attacks;
+}
+
+// Xorshift generator used to search for magics; fixed seed keeps startup deterministic
+static Bitboard nextRandom(Bitboard& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+// Find a magic for every square of one slider type and fill its attack table
+static void initMagics(Magic magics[64], Bitboard* table, const int directions[4][2]) {
+    const Bitboard RANK_EDGES = 0xFF000000000000FFULL;
+    const Bitboard FILE_EDGES = 0x8181818181818181ULL;
+
+    Bitboard occupancy[4096], reference[4096];
+    int epoch[4096] = { 0 };
+    int attempt = 0;
+
+    // Per-rank seeds that are known to find magics within a few hundred tries
+    const Bitboard rankSeeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+
+    for (int square = 0; square < 64; square++) {
+        Magic& m = magics[square];
+
+        // Board edges never block unless the slider stands on that edge line
+        Bitboard edges = (RANK_EDGES & ~(0xFFULL << (square / 8 * 8))) |
+            (FILE_EDGES & ~(0x0101010101010101ULL << (square % 8)));
+        m.mask = slidingAttacks(square, 0, directions) & ~edges;
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = square == 0 ? table : magics[square - 1].attacks + (1 << (64 - magics[square - 1].shift));
+
+        // Enumerate every blocker subset of the mask (carry-rippler) with its true attack set
+        int size = 0;
+        Bitboard subset = 0;
+        do {
+            occupancy[size] = subset;
+            reference[size] = slidingAttacks(square, subset, directions);
+            size++;
+            subset = (subset - m.mask) & m.mask;
+        } while (subset);
+
+        // Try sparse random multipliers until no two subsets with different attacks collide
+        Bitboard seed = rankSeeds[square / 8];
+        for (int i = 0; i < size;) {
+            do {
+                m.magic = nextRandom(seed) & nextRandom(seed) & nextRandom(seed);
+            } while (popCount((m.mask * m.magic) >> 56) < 6);
+
+            attempt++;
+            for (i = 0; i < size; i++) {
+                unsigned index = magicIndex(m, occupancy[i]);
+                if (epoch[index] < attempt) {
+                    epoch[index] = attempt;
+                    m.attacks[index] = reference[i];
+                }
+                else if (m.attacks[index] != reference[i]) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Fill the between and line tables for every pair of squares sharing a rank, file or diagonal
+static void initLineTables() {
+    for (int a = 0; a < 64; a++) {
+        for (int b = 0; b < 64; b++) {
+            betweenSquares[a][b] = 0;
+            lineThrough[a][b] = 0;
+            if (a == b) continue;
+
+            if (rookAttacks(a, 0) & squareBit(b)) {
+                betweenSquares[a][b] = rookAttacks(a, squareBit(b)) & rookAttacks(b, squareBit(a));
+                lineThrough[a][b] = (rookAttacks(a, 0) & rookAttacks(b, 0)) | squareBit(a) | squareBit(b);
+            }
+            else if (bishopAttacks(a, 0) & squareBit(b)) {
+                betweenSquares[a][b] = bishopAttacks(a, squareBit(b)) & bishopAttacks(b, squareBit(a));
+                lineThrough[a][b] = (bishopAttacks(a, 0) & bishopAttacks(b, 0)) | squareBit(a) | squareBit(b);
+            }
+        }
+    }
+}
+
+// Fill the knight, king, pawn and sliding attack tables
+void initAttackTables() {
+    const int knightSteps[8][2] = {
+        {2, 1}, {2, -1}, {-2, 1}, {-2, -1},
+        {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
+    };
+    const int kingSteps[8][2] = {
+        {1, -1}, {1, 0}, {1, 1}, {0, -1},
+        {0, 1}, {-1, -1}, {-1, 0}, {-1, 1}
+    };
+    const int whitePawnSteps[2][2] = { {1, -1}, {1, 1} };
+    const int blackPawnSteps[2][2] = { {-1, -1}, {-1, 1} };
+
+    for (int square = 0; square < 64; square++) {
+        knightAttacks[square] = stepAttacks(square, knightSteps, 8);
+        kingAttacks[square] = stepAttacks(square, kingSteps, 8);
+        pawnAttacks[WHITE][square] = stepAttacks(square, whitePawnSteps, 2);
+        pawnAttacks[BLACK][square] = stepAttacks(square, blackPawnSteps, 2);
+    }
+
+    initMagics(rookMagics, rookAttackTable, ROOK_DIRECTIONS);
+    initMagics(bishopMagics, bishopAttackTable, BISHOP_DIRECTIONS);
+    initLineTables();
+}
@@ -0,0 +1,58 @@
+#ifndef CHESS_BITBOARD_H
+#define CHESS_BITBOARD_H
+
+#include "types.h"
+
+// Precomputed attack sets for the non-sliding pieces
+extern Bitboard knightAttacks[64];
+extern Bitboard kingAttacks[64];
+extern Bitboard pawnAttacks[2][64];
+
+// Squares strictly between two aligned squares, and the full line through them (0 if not aligned)
+extern Bitboard betweenSquares[64][64];
+extern Bitboard lineThrough[64][64];
+
+// Magic bitboard entry: attacks = table[((occupied & mask) * magic) >> shift]
+struct Magic {
+    Bitboard mask;     // Squares whose occupancy can block the slider
+    Bitboard magic;    // Multiplier that hashes every blocker subset without harmful collisions
+    Bitboard* attacks; // This square's slice of the shared attack table
+    int shift;         // 64 - popCount(mask)
+};
+
+extern Magic rookMagics[64];
+extern Magic bishopMagics[64];
+
+// Fill the knight, king, pawn and sliding attack tables
+void initAttackTables();
+
+// Index of an occupancy in a square's slice of the attack table
+inline unsigned magicIndex(const Magic& m, Bitboard occupied) {
+    return (unsigned)(((occupied & m.mask) * m.magic) >> m.shift);
+}
+
+// Squares a rook on square attacks through the given occupancy
+inline Bitboard rookAttacks(int square, Bitboard occupied) {
+    const Magic& m = rookMagics[square];
+    return m.attacks[magicIndex(m, occupied)];
+}
+
+// Squares a bishop on square attacks through the given occupancy
+inline Bitboard bishopAttacks(int square, Bitboard occupied) {
+    const Magic& m = bishopMagics[square];
+    return m.attacks[magicIndex(m, occupied)];
+}
+
+// Attack set of a non-pawn piece standing on square
+inline Bitboard pieceAttacks(PieceType type, int square, Bitboard occupied) {
+    switch (type) {
+    case KNIGHT: return knightAttacks[square];
+    case BISHOP: return bishopAttacks(square, occupied);
+    case ROOK: return rookAttacks(square, occupied);
+    case QUEEN: return bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+    case KING: return kingAttacks[square];
+    default: return 0;
+    }
+}
+
+#endif
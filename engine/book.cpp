@@ -0,0 +1,173 @@
+#include "book.h"
+
+// Offsets of the non-piece keys in Polyglot's random numbers
+const int POLYGLOT_CASTLING = 768;
+const int POLYGLOT_EN_PASSANT = 772;
+const int POLYGLOT_TURN = 780;
+
+// Polyglot piece kinds: black pawn, white pawn, black knight, ... white king, indexed by PieceType
+static const int POLYGLOT_KIND[6] = { 0, 6, 2, 4, 8, 10 }; // PAWN, ROOK, KNIGHT, BISHOP, QUEEN, KING
+
+// Read a big-endian number of the given byte count
+static inline unsigned long long readBigEndian(const unsigned char* bytes, int count) {
+    unsigned long long value = 0;
+    for (int i = 0; i < count; i++) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+// Value of a hex digit, or -1
+static inline int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Load the random numbers as raw big-endian values or as "0x..." literals in text
+bool loadPolyglotRandom(OpeningBook& book, const char* path) {
+    MappedFile file;
+    if (!openMappedFile(file, path)) {
+        return false;
+    }
+    const unsigned char* bytes = (const unsigned char*)file.data;
+    int count = 0;
+
+    if (file.size == (size_t)POLYGLOT_RANDOM_COUNT * 8) {
+        for (; count < POLYGLOT_RANDOM_COUNT; count++) {
+            book.random[count] = readBigEndian(bytes + count * 8, 8);
+        }
+    }
+    else {
+        for (size_t i = 0; i + 2 < file.size && count < POLYGLOT_RANDOM_COUNT; i++) {
+            if (file.data[i] != '0' || (file.data[i + 1] | 0x20) != 'x' || hexDigit(file.data[i + 2]) < 0) continue;
+            unsigned long long value = 0;
+            for (i += 2; i < file.size && hexDigit(file.data[i]) >= 0; i++) {
+                value = (value << 4) | hexDigit(file.data[i]);
+            }
+            book.random[count++] = value;
+        }
+    }
+    closeMappedFile(file);
+    book.hasRandom = count == POLYGLOT_RANDOM_COUNT;
+    return book.hasRandom;
+}
+
+// Map the book file; its entries are read straight from the mapping
+bool openBook(OpeningBook& book, const char* path) {
+    closeBook(book);
+    if (!openMappedFile(book.file, path)) {
+        return false;
+    }
+    if (book.file.size % POLYGLOT_ENTRY_SIZE != 0) {
+        closeMappedFile(book.file);
+        return false;
+    }
+    book.entryCount = book.file.size / POLYGLOT_ENTRY_SIZE;
+    return true;
+}
+
+// Unmap the book
+void closeBook(OpeningBook& book) {
+    closeMappedFile(book.file);
+    book.entryCount = 0;
+}
+
+// Polyglot hash of a position; en passant counts only when a pawn can capture, as in our own keys
+unsigned long long polyglotKey(const OpeningBook& book, const Position& pos) {
+    unsigned long long key = 0;
+    Bitboard occupied = pos.occupied;
+    while (occupied) {
+        int square = popLsb(occupied);
+        const Piece& piece = pos.squares[square];
+        int kind = POLYGLOT_KIND[piece.type] + (piece.isWhite ? 1 : 0);
+        key ^= book.random[64 * kind + square];
+    }
+
+    if (pos.castlingRights & WHITE_OO) key ^= book.random[POLYGLOT_CASTLING + 0];
+    if (pos.castlingRights & WHITE_OOO) key ^= book.random[POLYGLOT_CASTLING + 1];
+    if (pos.castlingRights & BLACK_OO) key ^= book.random[POLYGLOT_CASTLING + 2];
+    if (pos.castlingRights & BLACK_OOO) key ^= book.random[POLYGLOT_CASTLING + 3];
+    if (pos.epSquare != NO_SQUARE) key ^= book.random[POLYGLOT_EN_PASSANT + pos.epSquare % 8];
+    if (pos.whiteToMove) key ^= book.random[POLYGLOT_TURN];
+    return key;
+}
+
+// Key of the entry at an index
+static inline unsigned long long entryKey(const OpeningBook& book, size_t index) {
+    return readBigEndian((const unsigned char*)book.file.data + index * POLYGLOT_ENTRY_SIZE, 8);
+}
+
+// Turn a Polyglot move (castling written as king takes own rook) into the matching legal move
+static Move decodeBookMove(const MoveList& legal, const Position& pos, int bookMove) {
+    int to = bookMove & 63;
+    int from = (bookMove >> 6) & 63;
+    int promotion = (bookMove >> 12) & 7; // 0 none, 1 knight ... 4 queen
+    if (pos.squares[from].type == KING && pos.squares[to].type == ROOK &&
+        pos.squares[to].isWhite == pos.squares[from].isWhite) {
+        to = to > from ? from + 2 : from - 2;
+    }
+
+    for (int i = 0; i < legal.count; i++) {
+        Move move = legal.moves[i];
+        if (moveFrom(move) != from || moveTo(move) != to) continue;
+        if (moveFlag(move) == PROMOTION ? ((move >> 12) & 3) + 1 != promotion : promotion != 0) continue;
+        return move;
+    }
+    return 0;
+}
+
+// Binary search for the first entry of the position, then collect its legal moves
+int probeBook(const OpeningBook& book, const Position& pos, BookMove* moves, int maxMoves) {
+    if (!isBookReady(book)) {
+        return 0;
+    }
+    unsigned long long key = polyglotKey(book, pos);
+    size_t low = 0, high = book.entryCount;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (entryKey(book, middle) < key) low = middle + 1;
+        else high = middle;
+    }
+    if (low == book.entryCount || entryKey(book, low) != key) {
+        return 0;
+    }
+
+    MoveList legal;
+    generateMoves(pos, legal);
+    int count = 0;
+    for (size_t index = low; index < book.entryCount && count < maxMoves && entryKey(book, index) == key; index++) {
+        const unsigned char* entry = (const unsigned char*)book.file.data + index * POLYGLOT_ENTRY_SIZE;
+        Move move = decodeBookMove(legal, pos, (int)readBigEndian(entry + 8, 2));
+        if (move != 0) {
+            moves[count].move = move;
+            moves[count].weight = (int)readBigEndian(entry + 10, 2);
+            count++;
+        }
+    }
+    return count;
+}
+
+// Weighted choice among the position's book moves; zero-weight moves are only played
+// if every move has weight zero
+Move pickBookMove(const OpeningBook& book, const Position& pos, unsigned random) {
+    BookMove moves[64];
+    int count = probeBook(book, pos, moves, 64);
+    if (count == 0) {
+        return 0;
+    }
+    unsigned long long total = 0;
+    for (int i = 0; i < count; i++) {
+        total += moves[i].weight;
+    }
+    if (total == 0) {
+        return moves[random % count].move;
+    }
+    unsigned long long pick = random % total;
+    for (int i = 0; i < count; i++) {
+        if (pick < (unsigned long long)moves[i].weight) return moves[i].move;
+        pick -= moves[i].weight;
+    }
+    return moves[count - 1].move;
+}
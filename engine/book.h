@@ -0,0 +1,56 @@
+#ifndef CHESS_BOOK_H
+#define CHESS_BOOK_H
+
+#include "mappedfile.h"
+#include "movegen.h"
+
+// Polyglot hashes a position with its own 781 random numbers: 768 piece-square keys,
+// 4 castling keys, 8 en passant file keys and 1 side-to-move key
+const int POLYGLOT_RANDOM_COUNT = 781;
+
+// Size of one book entry: key, move, weight and learn fields, big-endian
+const int POLYGLOT_ENTRY_SIZE = 16;
+
+// A Polyglot .bin opening book: the file is mapped and searched in place, entries
+// sorted by key, so opening it costs nothing however large it is
+struct OpeningBook {
+    MappedFile file;
+    size_t entryCount;
+    unsigned long long random[POLYGLOT_RANDOM_COUNT];
+    bool hasRandom; // Keys loaded; the book cannot be probed without them
+
+    OpeningBook() : entryCount(0), hasRandom(false) {}
+};
+
+// One book move for a position
+struct BookMove {
+    Move move;
+    int weight;
+};
+
+// Load Polyglot's random numbers, either as a raw file of 781 big-endian 64-bit values
+// or from text listing them as hex literals in order (such as Polyglot's pg_key.c)
+bool loadPolyglotRandom(OpeningBook& book, const char* path);
+
+// Map a Polyglot book; returns false if the file cannot be mapped or is not a whole number of entries
+bool openBook(OpeningBook& book, const char* path);
+
+// Unmap the book
+void closeBook(OpeningBook& book);
+
+// Check if the book is open and has its keys
+inline bool isBookReady(const OpeningBook& book) {
+    return book.entryCount > 0 && book.hasRandom;
+}
+
+// Polyglot hash of a position
+unsigned long long polyglotKey(const OpeningBook& book, const Position& pos);
+
+// Fill moves with the legal book moves for a position; returns how many there are
+int probeBook(const OpeningBook& book, const Position& pos, BookMove* moves, int maxMoves);
+
+// Pick a book move with probability proportional to its weight, using a random number;
+// 0 if the position is not in the book
+Move pickBookMove(const OpeningBook& book, const Position& pos, unsigned random);
+
+#endif
@@ -0,0 +1,11 @@
+#include "engine.h"
+
+// Build the attack, castling, hash and piece-square tables and pick the NNUE kernels; call once before
+// using any position
+void initEngine() {
+    initAttackTables();
+    initCastlingMask();
+    initZobrist();
+    initPieceSquareTables();
+    initNnue();
+}
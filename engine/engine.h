@@ -0,0 +1,28 @@
+#ifndef CHESS_ENGINE_H
+#define CHESS_ENGINE_H
+
+// Rules engine: bitboard position, move generation, SAN and PGN, opening book, endgame
+// tablebases, perft, classical and NNUE evaluation and search. Has no OpenGL dependency,
+// so headless tools can link it on their own.
+#include "types.h"
+#include "bitboard.h"
+#include "zobrist.h"
+#include "psqt.h"
+#include "position.h"
+#include "movegen.h"
+#include "perft.h"
+#include "tt.h"
+#include "evaluate.h"
+#include "nnue.h"
+#include "search.h"
+#include "san.h"
+#include "pgn.h"
+#include "mappedfile.h"
+#include "book.h"
+#include "tablebase.h"
+
+// Build the attack, castling and hash tables and pick the NNUE kernels; call once before
+// using any position
+void initEngine();
+
+#endif
@@ -0,0 +1,125 @@
+#include "evaluate.h"
+
+#include <cstring>
+
+const int PIECE_VALUES[7] = { 100, 500, 320, 330, 900, 0, 0 };
+
+// Pawn structure terms, midgame and endgame
+static const Score DOUBLED_PAWN = makeScore(-11, -28);  // Per pawn with another of its color ahead on its file
+static const Score ISOLATED_PAWN = makeScore(-10, -14); // No pawns of its color on the neighbouring files
+static const Score BACKWARD_PAWN = makeScore(-9, -12);  // Neighbours all ahead of it and its stop square guarded
+
+// Passed pawn bonus by rank, counted from the pawn's own side
+static const Score PASSED_PAWN[8] = {
+    0, makeScore(2, 8), makeScore(5, 12), makeScore(12, 25),
+    makeScore(25, 45), makeScore(45, 80), makeScore(70, 120), 0
+};
+
+// King shelter bonus for the rearmost pawn on the king's file and each file beside it, when it
+// stands on its side's second or third rank
+static const int SHELTER_SECOND_RANK = 22;
+static const int SHELTER_THIRD_RANK = 12;
+
+static const Bitboard FILE_A = 0x0101010101010101ULL;
+
+// Files either side of a file
+static inline Bitboard adjacentFiles(int file) {
+    return (file > 0 ? FILE_A << (file - 1) : 0) | (file < 7 ? FILE_A << (file + 1) : 0);
+}
+
+// Ranks strictly ahead of a rank from one color's side; a pawn is never on its last rank
+static inline Bitboard ranksAhead(Color color, int rank) {
+    return color == WHITE ? ~0ULL << (8 * (rank + 1)) : (1ULL << (8 * rank)) - 1;
+}
+
+// Compute the pawn structure terms and king shelter of a position's pawns
+static void evaluatePawns(const Position& pos, PawnEntry& entry) {
+    entry.key = pos.pawnKey;
+    entry.score = 0;
+    for (int color = WHITE; color <= BLACK; color++) {
+        Bitboard own = pos.pieces[color][PAWN];
+        Bitboard enemy = pos.pieces[color ^ 1][PAWN];
+        Score score = 0;
+
+        Bitboard pawns = own;
+        while (pawns) {
+            int square = popLsb(pawns);
+            int file = square % 8, rank = square / 8;
+            Bitboard ahead = ranksAhead((Color)color, rank);
+            Bitboard neighbours = adjacentFiles(file);
+
+            if (own & ahead & (FILE_A << file)) {
+                score += DOUBLED_PAWN;
+            }
+            if ((own & neighbours) == 0) {
+                score += ISOLATED_PAWN;
+            }
+            else if ((own & neighbours & ~ahead) == 0 &&
+                (pawnAttacks[color][color == WHITE ? square + 8 : square - 8] & enemy) != 0) {
+                score += BACKWARD_PAWN;
+            }
+            if ((enemy & ahead & (neighbours | (FILE_A << file))) == 0) {
+                score += PASSED_PAWN[color == WHITE ? rank : 7 - rank];
+            }
+        }
+        entry.score += color == WHITE ? score : -score;
+
+        // Shelter for a king on each file: its own file and the ones beside it
+        int fileShelter[8];
+        for (int file = 0; file < 8; file++) {
+            Bitboard filePawns = own & (FILE_A << file);
+            int rank = filePawns == 0 ? -1 : color == WHITE ? lsb(filePawns) / 8 : 7 - (63 - __builtin_clzll(filePawns)) / 8;
+            fileShelter[file] = rank == 1 ? SHELTER_SECOND_RANK : rank == 2 ? SHELTER_THIRD_RANK : 0;
+        }
+        for (int file = 0; file < 8; file++) {
+            entry.shelter[color][file] = (short)(fileShelter[file] +
+                (file > 0 ? fileShelter[file - 1] : 0) + (file < 7 ? fileShelter[file + 1] : 0));
+        }
+    }
+}
+
+// Shelter of one color's king while it stays on its first two ranks
+static inline int kingShelter(const Position& pos, const PawnEntry& entry, Color color) {
+    int king = lsb(pos.pieces[color][KING]);
+    int rank = color == WHITE ? king / 8 : 7 - king / 8;
+    return rank <= 1 ? entry.shelter[color][king % 8] : 0;
+}
+
+// Blend the running score and the pawn terms by game phase, from the side to move's view
+static inline int taperedScore(const Position& pos, const PawnEntry& entry) {
+    Score total = pos.psqtScore + entry.score +
+        makeScore(kingShelter(pos, entry, WHITE) - kingShelter(pos, entry, BLACK), 0);
+
+    // Promotions can push the phase past a full set of pieces
+    int phase = pos.phase < MAX_PHASE ? pos.phase : MAX_PHASE;
+    int score = (midgameValue(total) * phase + endgameValue(total) * (MAX_PHASE - phase)) / MAX_PHASE;
+    return pos.whiteToMove ? score : -score;
+}
+
+// Empty every entry and reset the hit counters
+void clearPawnTable(PawnTable& table) {
+    // Zero keys only match the pawnless formation at index 0, whose terms are all zero
+    memset(table.entries, 0, sizeof(table.entries));
+    table.probes = 0;
+    table.hits = 0;
+}
+
+// Static evaluation in centipawns from the side to move's point of view
+int evaluate(const Position& pos, PawnTable& pawnTable) {
+    PawnEntry& entry = pawnTable.entries[pos.pawnKey & (PAWN_TABLE_SIZE - 1)];
+    pawnTable.probes++;
+    if (entry.key == pos.pawnKey) {
+        pawnTable.hits++;
+    }
+    else {
+        evaluatePawns(pos, entry);
+    }
+    return taperedScore(pos, entry);
+}
+
+// The same evaluation with the pawn terms computed from scratch
+int evaluate(const Position& pos) {
+    PawnEntry entry;
+    evaluatePawns(pos, entry);
+    return taperedScore(pos, entry);
+}
@@ -0,0 +1,38 @@
+#ifndef CHESS_EVALUATE_H
+#define CHESS_EVALUATE_H
+
+#include "position.h"
+
+// Material value of each piece type in centipawns for move ordering (king and empty count as zero)
+extern const int PIECE_VALUES[7];
+
+// Pawn structure terms of one pawn formation. They depend on the pawns alone, so they are
+// cached by the position's pawn key; an all-zero entry is the correct one for no pawns.
+struct PawnEntry {
+    Key key;
+    Score score;         // Doubled, isolated, backward and passed pawns, for white
+    short shelter[2][8]; // [Color][king file]: midgame bonus for own pawns in front of the king
+};
+
+// Entries in each search thread's pawn table (power of two)
+const int PAWN_TABLE_SIZE = 1 << 13;
+
+// Per-thread cache of pawn structure terms, indexed by pawn key
+struct PawnTable {
+    PawnEntry entries[PAWN_TABLE_SIZE];
+    unsigned long long probes;
+    unsigned long long hits;
+};
+
+// Empty every entry and reset the hit counters
+void clearPawnTable(PawnTable& table);
+
+// Static evaluation in centipawns from the side to move's point of view: the running material
+// and piece-square score plus pawn structure and king shelter, blended from midgame to
+// endgame values as pieces come off. The pawn terms come from the table when it has them.
+int evaluate(const Position& pos, PawnTable& pawnTable);
+
+// The same evaluation with the pawn terms computed from scratch, for one-off callers
+int evaluate(const Position& pos);
+
+#endif
@@ -0,0 +1,96 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+// Map a whole file read-only through a file mapping object
+bool openMappedFile(MappedFile& file, const char* path) {
+    closeMappedFile(file);
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(handle);
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(handle);
+    if (mapping == NULL) {
+        return false;
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        CloseHandle(mapping);
+        return false;
+    }
+    file.data = (const char*)view;
+    file.size = (size_t)size.QuadPart;
+    file.handle = mapping;
+    return true;
+}
+
+// Unmap the view and release the mapping object
+void closeMappedFile(MappedFile& file) {
+    if (file.data != NULL) {
+        UnmapViewOfFile(file.data);
+    }
+    if (file.handle != NULL) {
+        CloseHandle((HANDLE)file.handle);
+    }
+    file.data = NULL;
+    file.size = 0;
+    file.handle = NULL;
+}
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Map a whole file read-only with mmap; the descriptor is not needed once mapped
+bool openMappedFile(MappedFile& file, const char* path) {
+    closeMappedFile(file);
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        close(descriptor);
+        return false;
+    }
+    if (info.st_size == 0) {
+        close(descriptor);
+        return true;
+    }
+
+    void* view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    file.data = (const char*)view;
+    file.size = (size_t)info.st_size;
+    return true;
+}
+
+// Unmap the file
+void closeMappedFile(MappedFile& file) {
+    if (file.data != NULL) {
+        munmap((void*)file.data, file.size);
+    }
+    file.data = NULL;
+    file.size = 0;
+    file.handle = NULL;
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef CHESS_MAPPEDFILE_H
+#define CHESS_MAPPEDFILE_H
+
+#include <cstddef>
+
+// A read-only file mapped into memory, so large archives and books are paged in on
+// demand instead of being read up front
+struct MappedFile {
+    const char* data; // NULL for an empty or unopened file
+    size_t size;
+    void* handle;     // Platform mapping handle (Windows only)
+
+    MappedFile() : data(NULL), size(0), handle(NULL) {}
+};
+
+// Map a whole file read-only; returns false if it cannot be opened or mapped
+bool openMappedFile(MappedFile& file, const char* path);
+
+// Unmap the file
+void closeMappedFile(MappedFile& file);
+
+#endif
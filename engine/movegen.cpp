@@ -0,0 +1,231 @@
+#include "movegen.h"
+
+// Check and pin restrictions, computed once per position before generating
+struct MoveMasks {
+    int kingSquare;
+    int checkerCount;
+    Bitboard checkMask; // Non-king moves must land here: the checker and its ray, or everything
+    Bitboard pinned;    // Own pieces that may only move along the line through their king
+};
+
+// Find checkers and absolutely pinned pieces of the side to move
+static MoveMasks computeMoveMasks(const Position& pos) {
+    Color us = colorOf(pos.whiteToMove);
+    Color them = colorOf(!pos.whiteToMove);
+    const Bitboard* enemy = pos.pieces[them];
+    MoveMasks masks;
+
+    masks.kingSquare = lsb(pos.pieces[us][KING]);
+    Bitboard checkers = attackersTo(pos, masks.kingSquare, pos.occupied) & pos.colorPieces[them];
+    masks.checkerCount = popCount(checkers);
+    masks.checkMask = ~0ULL;
+    if (masks.checkerCount == 1) {
+        int checker = lsb(checkers);
+        masks.checkMask = betweenSquares[masks.kingSquare][checker] | checkers;
+    }
+
+    // A slider that would hit the king through exactly one own piece pins that piece
+    masks.pinned = 0;
+    Bitboard snipers =
+        (rookAttacks(masks.kingSquare, pos.colorPieces[them]) & (enemy[ROOK] | enemy[QUEEN])) |
+        (bishopAttacks(masks.kingSquare, pos.colorPieces[them]) & (enemy[BISHOP] | enemy[QUEEN]));
+    while (snipers) {
+        Bitboard blockers = betweenSquares[masks.kingSquare][popLsb(snipers)] & pos.occupied;
+        if (popCount(blockers) == 1) {
+            masks.pinned |= blockers & pos.colorPieces[us];
+        }
+    }
+    return masks;
+}
+
+// Append one move per target square
+static inline void addMoves(MoveList& list, int from, Bitboard targets) {
+    while (targets) {
+        list.moves[list.count++] = encodeMove(from, popLsb(targets));
+    }
+}
+
+// Append all four promotions of one pawn move
+static inline void addPromotions(MoveList& list, int from, int to) {
+    for (int promotion = 3; promotion >= 0; promotion--) {
+        list.moves[list.count++] = encodeMove(from, to, PROMOTION, promotion);
+    }
+}
+
+// Append pawn moves to targets, expanding those on the last rank into promotions
+static inline void addPawnMoves(MoveList& list, int from, Bitboard targets, Bitboard lastRank) {
+    while (targets) {
+        int to = popLsb(targets);
+        if (squareBit(to) & lastRank) {
+            addPromotions(list, from, to);
+        }
+        else {
+            list.moves[list.count++] = encodeMove(from, to);
+        }
+    }
+}
+
+// Check that an en passant capture does not expose the king; both pawns leave
+// the same rank at once, so this is tested on the resulting occupancy
+static bool isLegalEnPassant(const Position& pos, int from, int to, int kingSquare) {
+    Color them = colorOf(!pos.whiteToMove);
+    int capturedSquare = pos.whiteToMove ? to - 8 : to + 8;
+    Bitboard occupied = (pos.occupied ^ squareBit(from) ^ squareBit(capturedSquare)) | squareBit(to);
+    Bitboard attackers = attackersTo(pos, kingSquare, occupied) & pos.colorPieces[them];
+    return !(attackers & ~squareBit(capturedSquare));
+}
+
+// Generate pawn pushes, captures, promotions and en passant; capturesOnly keeps only
+// captures and promotions
+static void generatePawnMoves(const Position& pos, const MoveMasks& masks, bool capturesOnly, MoveList& list) {
+    bool white = pos.whiteToMove;
+    Color us = colorOf(white);
+    Bitboard pawns = pos.pieces[us][PAWN];
+    Bitboard enemies = pos.colorPieces[colorOf(!white)];
+    Bitboard empty = ~pos.occupied;
+    Bitboard lastRank = white ? 0xFF00000000000000ULL : 0x00000000000000FFULL;
+    Bitboard doubleRank = white ? 0x00000000FF000000ULL : 0x000000FF00000000ULL;
+    int forward = white ? 8 : -8;
+
+    // Pushes of unpinned pawns are generated for the whole set at once
+    Bitboard free = pawns & ~masks.pinned;
+    Bitboard single = (white ? free << 8 : free >> 8) & empty;
+    Bitboard twice = (white ? single << 8 : single >> 8) & empty & doubleRank;
+    single &= masks.checkMask;
+    twice &= masks.checkMask;
+    if (capturesOnly) {
+        single &= lastRank;
+        twice = 0;
+    }
+
+    Bitboard targets = single & ~lastRank;
+    while (targets) {
+        int to = popLsb(targets);
+        list.moves[list.count++] = encodeMove(to - forward, to);
+    }
+    targets = single & lastRank;
+    while (targets) {
+        int to = popLsb(targets);
+        addPromotions(list, to - forward, to);
+    }
+    while (twice) {
+        int to = popLsb(twice);
+        list.moves[list.count++] = encodeMove(to - 2 * forward, to);
+    }
+
+    // Captures of unpinned pawns use the per-square pawn attack table
+    while (free) {
+        int from = popLsb(free);
+        addPawnMoves(list, from, pawnAttacks[us][from] & enemies & masks.checkMask, lastRank);
+    }
+
+    // Pinned pawns may still push or capture along the pin line
+    Bitboard pinnedPawns = pawns & masks.pinned;
+    while (pinnedPawns) {
+        int from = popLsb(pinnedPawns);
+        Bitboard allowed = lineThrough[masks.kingSquare][from] & masks.checkMask;
+        Bitboard pushes = squareBit(from + forward) & empty;
+        if (pushes && (squareBit(from) & (white ? 0x000000000000FF00ULL : 0x00FF000000000000ULL))) {
+            pushes |= squareBit(from + 2 * forward) & empty;
+        }
+        if (capturesOnly) pushes &= lastRank;
+        addPawnMoves(list, from, (pushes | (pawnAttacks[us][from] & enemies)) & allowed, lastRank);
+    }
+
+    // En passant is rare enough to verify against the resulting occupancy
+    if (pos.epSquare != NO_SQUARE) {
+        Bitboard capturers = pawnAttacks[colorOf(!white)][pos.epSquare] & pawns;
+        while (capturers) {
+            int from = popLsb(capturers);
+            if (isLegalEnPassant(pos, from, pos.epSquare, masks.kingSquare)) {
+                list.moves[list.count++] = encodeMove(from, pos.epSquare, EN_PASSANT);
+            }
+        }
+    }
+}
+
+// Generate king steps to squares the enemy does not attack once the king has left its square
+static void generateKingMoves(const Position& pos, const MoveMasks& masks, Bitboard allowed, MoveList& list) {
+    Bitboard enemies = pos.colorPieces[colorOf(!pos.whiteToMove)];
+    Bitboard occupied = pos.occupied ^ squareBit(masks.kingSquare);
+
+    Bitboard targets = kingAttacks[masks.kingSquare] & allowed;
+    while (targets) {
+        int to = popLsb(targets);
+        if (!(attackersTo(pos, to, occupied) & enemies)) {
+            list.moves[list.count++] = encodeMove(masks.kingSquare, to);
+        }
+    }
+}
+
+// Generate castling moves; the king may not start on, pass over or land on an attacked square
+static void generateCastling(const Position& pos, MoveList& list) {
+    bool white = pos.whiteToMove;
+    int homeRow = white ? 0 : 7;
+    int kingSquare = squareOf(homeRow, 4);
+    int kingSide = white ? WHITE_OO : BLACK_OO;
+    int queenSide = white ? WHITE_OOO : BLACK_OOO;
+
+    // Rights are only ever set with the king and rooks at home; check anyway, since a castling
+    // move with either missing would corrupt the position
+    Color us = colorOf(white);
+    if (!(pos.castlingRights & (kingSide | queenSide)) || !(pos.pieces[us][KING] & squareBit(kingSquare))) {
+        return;
+    }
+
+    Bitboard kingSideGap = squareBit(squareOf(homeRow, 5)) | squareBit(squareOf(homeRow, 6));
+    if ((pos.castlingRights & kingSide) && (pos.pieces[us][ROOK] & squareBit(squareOf(homeRow, 7))) &&
+        !(pos.occupied & kingSideGap) &&
+        !isSquareAttacked(pos, squareOf(homeRow, 5), !white) &&
+        !isSquareAttacked(pos, squareOf(homeRow, 6), !white)) {
+        list.moves[list.count++] = encodeMove(kingSquare, squareOf(homeRow, 6), CASTLING);
+    }
+
+    Bitboard queenSideGap = squareBit(squareOf(homeRow, 1)) | squareBit(squareOf(homeRow, 2)) |
+        squareBit(squareOf(homeRow, 3));
+    if ((pos.castlingRights & queenSide) && (pos.pieces[us][ROOK] & squareBit(squareOf(homeRow, 0))) &&
+        !(pos.occupied & queenSideGap) &&
+        !isSquareAttacked(pos, squareOf(homeRow, 3), !white) &&
+        !isSquareAttacked(pos, squareOf(homeRow, 2), !white)) {
+        list.moves[list.count++] = encodeMove(kingSquare, squareOf(homeRow, 2), CASTLING);
+    }
+}
+
+// Generate legal moves, or with capturesOnly just captures and promotions
+static void generate(const Position& pos, bool capturesOnly, MoveList& list) {
+    MoveMasks masks = computeMoveMasks(pos);
+    Color us = colorOf(pos.whiteToMove);
+    Bitboard targetSquares = capturesOnly ? pos.colorPieces[colorOf(!pos.whiteToMove)] : ~pos.colorPieces[us];
+
+    // In double check only the king can move
+    if (masks.checkerCount < 2) {
+        Bitboard allowed = targetSquares & masks.checkMask;
+
+        generatePawnMoves(pos, masks, capturesOnly, list);
+        for (int type = ROOK; type <= QUEEN; type++) {
+            Bitboard pieces = pos.pieces[us][type];
+            while (pieces) {
+                int from = popLsb(pieces);
+                Bitboard targets = pieceAttacks((PieceType)type, from, pos.occupied) & allowed;
+                if (masks.pinned & squareBit(from)) {
+                    targets &= lineThrough[masks.kingSquare][from];
+                }
+                addMoves(list, from, targets);
+            }
+        }
+        if (masks.checkerCount == 0 && !capturesOnly) {
+            generateCastling(pos, list);
+        }
+    }
+    generateKingMoves(pos, masks, targetSquares, list);
+}
+
+// Generate legal moves for the side to move
+void generateMoves(const Position& pos, MoveList& list) {
+    generate(pos, false, list);
+}
+
+// Generate legal captures, en passant and promotions for the side to move
+void generateCaptures(const Position& pos, MoveList& list) {
+    generate(pos, true, list);
+}
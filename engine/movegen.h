@@ -0,0 +1,21 @@
+#ifndef CHESS_MOVEGEN_H
+#define CHESS_MOVEGEN_H
+
+#include "position.h"
+
+// Fixed-capacity move list; no legal position has more than 218 moves
+struct MoveList {
+    Move moves[256];
+    int count;
+
+    MoveList() : count(0) {}
+};
+
+// Generate legal moves for the side to move. Checkers and pinned pieces are
+// found once up front, so no candidate move has to be made and taken back.
+void generateMoves(const Position& pos, MoveList& list);
+
+// Generate legal captures, en passant and promotions for the side to move
+void generateCaptures(const Position& pos, MoveList& list);
+
+#endif
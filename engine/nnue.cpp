@@ -0,0 +1,364 @@
+#include "nnue.h"
+#include "mappedfile.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// GCC and Clang compile the x86 kernels with per-function target attributes, so the rest of
+// the engine keeps running on CPUs without them; other compilers get the portable kernels
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NNUE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+static const char NNUE_MAGIC[NNUE_HEADER_SIZE] = { 'C', 'H', 'E', 'S', 'S', 'N', 'N', '1' };
+
+// Bytes of a network file
+static const size_t NNUE_FILE_SIZE = NNUE_HEADER_SIZE +
+    sizeof(short) * NNUE_HIDDEN + sizeof(short) * (size_t)NNUE_FEATURES * NNUE_HIDDEN +
+    sizeof(int) * NNUE_LAYER1 + NNUE_LAYER1 * 2 * NNUE_HIDDEN +
+    sizeof(int) * NNUE_LAYER2 + NNUE_LAYER2 * NNUE_LAYER1 +
+    sizeof(int) + NNUE_LAYER2;
+
+// The inner loops of the network, one set per instruction set
+struct NnueKernels {
+    const char* name;
+
+    // out = in + the added columns - the removed columns, NNUE_HIDDEN values each
+    void (*updateColumns)(short* out, const short* in, const short* const* added, int addedCount,
+        const short* const* removed, int removedCount);
+
+    // Clip NNUE_HIDDEN accumulator values to 0..127
+    void (*clipAccumulator)(const short* in, unsigned char* out);
+
+    // out[o] = biases[o] + the dot product of weight row o with the inputs; inputs come in
+    // multiples of 32 and outputs in multiples of 4
+    void (*affine)(const unsigned char* in, int inputs, const signed char* weights, const int* biases,
+        int outputs, int* out);
+};
+
+static void updateColumnsScalar(short* out, const short* in, const short* const* added, int addedCount,
+    const short* const* removed, int removedCount) {
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        int value = in[i];
+        for (int a = 0; a < addedCount; a++) value += added[a][i];
+        for (int r = 0; r < removedCount; r++) value -= removed[r][i];
+        out[i] = (short)value;
+    }
+}
+
+static void clipAccumulatorScalar(const short* in, unsigned char* out) {
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        out[i] = (unsigned char)(in[i] < 0 ? 0 : in[i] > 127 ? 127 : in[i]);
+    }
+}
+
+static void affineScalar(const unsigned char* in, int inputs, const signed char* weights, const int* biases,
+    int outputs, int* out) {
+    for (int o = 0; o < outputs; o++) {
+        const signed char* row = weights + o * inputs;
+        int sum = biases[o];
+        for (int i = 0; i < inputs; i++) {
+            sum += row[i] * in[i];
+        }
+        out[o] = sum;
+    }
+}
+
+static const NnueKernels SCALAR_KERNELS = { "scalar", updateColumnsScalar, clipAccumulatorScalar, affineScalar };
+
+#ifdef NNUE_X86_KERNELS
+
+// Inputs are at most 127 and weights at least -128, so a pair of products never saturates
+// maddubs and every kernel gives exactly the scalar result
+
+__attribute__((target("sse4.1")))
+static void updateColumnsSse41(short* out, const short* in, const short* const* added, int addedCount,
+    const short* const* removed, int removedCount) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i value = _mm_loadu_si128((const __m128i*)(in + i));
+        for (int a = 0; a < addedCount; a++) value = _mm_add_epi16(value, _mm_loadu_si128((const __m128i*)(added[a] + i)));
+        for (int r = 0; r < removedCount; r++) value = _mm_sub_epi16(value, _mm_loadu_si128((const __m128i*)(removed[r] + i)));
+        _mm_storeu_si128((__m128i*)(out + i), value);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void clipAccumulatorSse41(const short* in, unsigned char* out) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m128i packed = _mm_packs_epi16(_mm_loadu_si128((const __m128i*)(in + i)),
+            _mm_loadu_si128((const __m128i*)(in + i + 8)));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_max_epi8(packed, _mm_setzero_si128()));
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void affineSse41(const unsigned char* in, int inputs, const signed char* weights, const int* biases,
+    int outputs, int* out) {
+    // Four rows at a time share each input load and one horizontal sum
+    const __m128i ones = _mm_set1_epi16(1);
+    for (int o = 0; o < outputs; o += 4) {
+        const signed char* row = weights + o * inputs;
+        __m128i sum0 = _mm_setzero_si128(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+        for (int i = 0; i < inputs; i += 16) {
+            __m128i input = _mm_loadu_si128((const __m128i*)(in + i));
+            sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_maddubs_epi16(input, _mm_loadu_si128((const __m128i*)(row + i))), ones));
+            sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_maddubs_epi16(input, _mm_loadu_si128((const __m128i*)(row + inputs + i))), ones));
+            sum2 = _mm_add_epi32(sum2, _mm_madd_epi16(_mm_maddubs_epi16(input, _mm_loadu_si128((const __m128i*)(row + 2 * inputs + i))), ones));
+            sum3 = _mm_add_epi32(sum3, _mm_madd_epi16(_mm_maddubs_epi16(input, _mm_loadu_si128((const __m128i*)(row + 3 * inputs + i))), ones));
+        }
+        __m128i total = _mm_hadd_epi32(_mm_hadd_epi32(sum0, sum1), _mm_hadd_epi32(sum2, sum3));
+        _mm_storeu_si128((__m128i*)(out + o), _mm_add_epi32(total, _mm_loadu_si128((const __m128i*)(biases + o))));
+    }
+}
+
+__attribute__((target("avx2")))
+static void updateColumnsAvx2(short* out, const short* in, const short* const* added, int addedCount,
+    const short* const* removed, int removedCount) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i value = _mm256_loadu_si256((const __m256i*)(in + i));
+        for (int a = 0; a < addedCount; a++) value = _mm256_add_epi16(value, _mm256_loadu_si256((const __m256i*)(added[a] + i)));
+        for (int r = 0; r < removedCount; r++) value = _mm256_sub_epi16(value, _mm256_loadu_si256((const __m256i*)(removed[r] + i)));
+        _mm256_storeu_si256((__m256i*)(out + i), value);
+    }
+}
+
+__attribute__((target("avx2")))
+static void clipAccumulatorAvx2(const short* in, unsigned char* out) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+        // packs works within 128-bit lanes; the permute puts the 64-bit quarters back in order
+        __m256i packed = _mm256_packs_epi16(_mm256_loadu_si256((const __m256i*)(in + i)),
+            _mm256_loadu_si256((const __m256i*)(in + i + 16)));
+        packed = _mm256_permute4x64_epi64(packed, 0xD8);
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_max_epi8(packed, _mm256_setzero_si256()));
+    }
+}
+
+__attribute__((target("avx2")))
+static void affineAvx2(const unsigned char* in, int inputs, const signed char* weights, const int* biases,
+    int outputs, int* out) {
+    // Four rows at a time share each input load and one horizontal sum
+    const __m256i ones = _mm256_set1_epi16(1);
+    for (int o = 0; o < outputs; o += 4) {
+        const signed char* row = weights + o * inputs;
+        __m256i sum0 = _mm256_setzero_si256(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+        for (int i = 0; i < inputs; i += 32) {
+            __m256i input = _mm256_loadu_si256((const __m256i*)(in + i));
+            sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(_mm256_maddubs_epi16(input, _mm256_loadu_si256((const __m256i*)(row + i))), ones));
+            sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(_mm256_maddubs_epi16(input, _mm256_loadu_si256((const __m256i*)(row + inputs + i))), ones));
+            sum2 = _mm256_add_epi32(sum2, _mm256_madd_epi16(_mm256_maddubs_epi16(input, _mm256_loadu_si256((const __m256i*)(row + 2 * inputs + i))), ones));
+            sum3 = _mm256_add_epi32(sum3, _mm256_madd_epi16(_mm256_maddubs_epi16(input, _mm256_loadu_si256((const __m256i*)(row + 3 * inputs + i))), ones));
+        }
+        // hadd sums within 128-bit lanes, leaving each row's low and high half totals to add
+        __m256i pairs = _mm256_hadd_epi32(_mm256_hadd_epi32(sum0, sum1), _mm256_hadd_epi32(sum2, sum3));
+        __m128i total = _mm_add_epi32(_mm256_castsi256_si128(pairs), _mm256_extracti128_si256(pairs, 1));
+        _mm_storeu_si128((__m128i*)(out + o), _mm_add_epi32(total, _mm_loadu_si128((const __m128i*)(biases + o))));
+    }
+}
+
+static const NnueKernels SSE41_KERNELS = { "sse4.1", updateColumnsSse41, clipAccumulatorSse41, affineSse41 };
+static const NnueKernels AVX2_KERNELS = { "avx2", updateColumnsAvx2, clipAccumulatorAvx2, affineAvx2 };
+
+#endif
+
+static NnueKernels kernels = SCALAR_KERNELS;
+
+// Pick the fastest kernels the CPU supports: AVX2, SSE4.1 or plain C++
+void initNnue() {
+    if (!selectNnueKernels("avx2") && !selectNnueKernels("sse4.1")) {
+        selectNnueKernels("scalar");
+    }
+}
+
+// Use the kernels of one instruction set; false if the CPU or the compiler lacks it
+bool selectNnueKernels(const char* name) {
+    if (strcmp(name, "scalar") == 0) {
+        kernels = SCALAR_KERNELS;
+        return true;
+    }
+#ifdef NNUE_X86_KERNELS
+    __builtin_cpu_init();
+    if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+        kernels = AVX2_KERNELS;
+        return true;
+    }
+    if (strcmp(name, "sse4.1") == 0 && __builtin_cpu_supports("sse4.1")) {
+        kernels = SSE41_KERNELS;
+        return true;
+    }
+#endif
+    return false;
+}
+
+// Instruction set of the kernels in use
+const char* nnueKernelName() {
+    return kernels.name;
+}
+
+// Decode count little-endian integers of type T and advance past them
+template <typename T>
+static void readLittleEndian(const unsigned char*& bytes, T* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        unsigned value = 0;
+        for (size_t b = 0; b < sizeof(T); b++) {
+            value |= (unsigned)bytes[b] << (8 * b);
+        }
+        out[i] = (T)value;
+        bytes += sizeof(T);
+    }
+}
+
+// Read a network file; returns false (leaving the network unloaded) if it is missing or malformed
+bool loadNnueNetwork(NnueNetwork& network, const char* path) {
+    freeNnueNetwork(network);
+    MappedFile file;
+    if (!openMappedFile(file, path)) {
+        return false;
+    }
+    if (file.size != NNUE_FILE_SIZE || memcmp(file.data, NNUE_MAGIC, NNUE_HEADER_SIZE) != 0) {
+        closeMappedFile(file);
+        return false;
+    }
+
+    network.memory = malloc(sizeof(NnueWeights) + 63);
+    if (!network.memory) {
+        closeMappedFile(file);
+        return false;
+    }
+    NnueWeights* weights = (NnueWeights*)(((size_t)network.memory + 63) & ~(size_t)63);
+    const unsigned char* bytes = (const unsigned char*)file.data + NNUE_HEADER_SIZE;
+    readLittleEndian(bytes, weights->featureBiases, NNUE_HIDDEN);
+    readLittleEndian(bytes, weights->featureWeights, (size_t)NNUE_FEATURES * NNUE_HIDDEN);
+    readLittleEndian(bytes, weights->hidden1Biases, NNUE_LAYER1);
+    readLittleEndian(bytes, weights->hidden1Weights, NNUE_LAYER1 * 2 * NNUE_HIDDEN);
+    readLittleEndian(bytes, weights->hidden2Biases, NNUE_LAYER2);
+    readLittleEndian(bytes, weights->hidden2Weights, NNUE_LAYER2 * NNUE_LAYER1);
+    readLittleEndian(bytes, &weights->outputBias, 1);
+    readLittleEndian(bytes, weights->outputWeights, NNUE_LAYER2);
+    closeMappedFile(file);
+    network.weights = weights;
+    return true;
+}
+
+// Release the network's weights
+void freeNnueNetwork(NnueNetwork& network) {
+    if (network.memory) {
+        free(network.memory);
+    }
+    network.memory = NULL;
+    network.weights = NULL;
+}
+
+// Weight column of a piece on a square, seen from one side with its king on kingSquare
+static inline const short* featureColumn(const NnueWeights& weights, int perspective, int kingSquare,
+    int square, Piece piece) {
+    int mirror = perspective == WHITE ? 0 : 56;
+    int kind = piece.type + (colorOf(piece.isWhite) == perspective ? 0 : 5);
+    size_t feature = ((size_t)(kingSquare ^ mirror) * NNUE_PIECE_KINDS + kind) * 64 + (square ^ mirror);
+    return weights.featureWeights + feature * NNUE_HIDDEN;
+}
+
+// Sum the biases and the columns of every piece but the kings for one side
+static void refreshPerspective(const NnueWeights& weights, const Position& pos, int perspective, short* out) {
+    const short* columns[64];
+    int count = 0;
+    int kingSquare = lsb(pos.pieces[perspective][KING]);
+    Bitboard pieces = pos.occupied & ~(pos.pieces[WHITE][KING] | pos.pieces[BLACK][KING]);
+    while (pieces) {
+        int square = popLsb(pieces);
+        columns[count++] = featureColumn(weights, perspective, kingSquare, square, pos.squares[square]);
+    }
+    kernels.updateColumns(out, weights.featureBiases, columns, count, NULL, 0);
+}
+
+// Compute both perspectives of a position's accumulator from scratch
+void refreshAccumulator(const NnueNetwork& network, const Position& pos, NnueAccumulator& accumulator) {
+    refreshPerspective(*network.weights, pos, WHITE, accumulator.values[WHITE]);
+    refreshPerspective(*network.weights, pos, BLACK, accumulator.values[BLACK]);
+}
+
+// Accumulator after makeMove(pos, move, undo), from the one before it
+void updateAccumulator(const NnueNetwork& network, const Position& pos, Move move, const UndoInfo& undo,
+    const NnueAccumulator& parent, NnueAccumulator& child) {
+    const NnueWeights& weights = *network.weights;
+    int from = moveFrom(move), to = moveTo(move);
+    MoveFlag flag = moveFlag(move);
+    Piece moved = pos.squares[to];
+
+    // Pieces that left and entered a square; kings are not features
+    int removedSquares[2], addedSquares[2];
+    Piece removedPieces[2], addedPieces[2];
+    int removedCount = 0, addedCount = 0;
+    if (flag == CASTLING) {
+        int row = from / 8;
+        bool kingSide = to > from;
+        removedSquares[removedCount] = squareOf(row, kingSide ? 7 : 0);
+        removedPieces[removedCount++] = Piece(ROOK, moved.isWhite);
+        addedSquares[addedCount] = squareOf(row, kingSide ? 5 : 3);
+        addedPieces[addedCount++] = Piece(ROOK, moved.isWhite);
+    }
+    else {
+        if (moved.type != KING) {
+            removedSquares[removedCount] = from;
+            removedPieces[removedCount++] = flag == PROMOTION ? Piece(PAWN, moved.isWhite) : moved;
+            addedSquares[addedCount] = to;
+            addedPieces[addedCount++] = moved;
+        }
+        if (undo.captured.type != EMPTY) {
+            removedSquares[removedCount] = flag == EN_PASSANT ? (moved.isWhite ? to - 8 : to + 8) : to;
+            removedPieces[removedCount++] = undo.captured;
+        }
+    }
+
+    for (int perspective = WHITE; perspective <= BLACK; perspective++) {
+        // Every feature of a side is relative to its king, so a king move starts that side over
+        if (moved.type == KING && colorOf(moved.isWhite) == perspective) {
+            refreshPerspective(weights, pos, perspective, child.values[perspective]);
+            continue;
+        }
+        int kingSquare = lsb(pos.pieces[perspective][KING]);
+        const short* added[2];
+        const short* removed[2];
+        for (int i = 0; i < addedCount; i++) {
+            added[i] = featureColumn(weights, perspective, kingSquare, addedSquares[i], addedPieces[i]);
+        }
+        for (int i = 0; i < removedCount; i++) {
+            removed[i] = featureColumn(weights, perspective, kingSquare, removedSquares[i], removedPieces[i]);
+        }
+        kernels.updateColumns(child.values[perspective], parent.values[perspective], added, addedCount,
+            removed, removedCount);
+    }
+}
+
+// Clip a hidden layer's sums to the next layer's 0..127 inputs
+static inline void clipLayer(const int* sums, unsigned char* out, int count) {
+    for (int i = 0; i < count; i++) {
+        int value = sums[i] >> NNUE_WEIGHT_SHIFT;
+        out[i] = (unsigned char)(value < 0 ? 0 : value > 127 ? 127 : value);
+    }
+}
+
+// Evaluation in centipawns from the side to move's point of view
+int evaluateNnue(const NnueNetwork& network, const NnueAccumulator& accumulator, bool whiteToMove) {
+    const NnueWeights& weights = *network.weights;
+    int us = colorOf(whiteToMove);
+    alignas(32) unsigned char input[2 * NNUE_HIDDEN];
+    kernels.clipAccumulator(accumulator.values[us], input);
+    kernels.clipAccumulator(accumulator.values[us ^ 1], input + NNUE_HIDDEN);
+
+    int sums[NNUE_LAYER1];
+    alignas(32) unsigned char hidden1[NNUE_LAYER1];
+    kernels.affine(input, 2 * NNUE_HIDDEN, weights.hidden1Weights, weights.hidden1Biases, NNUE_LAYER1, sums);
+    clipLayer(sums, hidden1, NNUE_LAYER1);
+
+    alignas(32) unsigned char hidden2[NNUE_LAYER2];
+    kernels.affine(hidden1, NNUE_LAYER1, weights.hidden2Weights, weights.hidden2Biases, NNUE_LAYER2, sums);
+    clipLayer(sums, hidden2, NNUE_LAYER2);
+
+    int output = weights.outputBias;
+    for (int i = 0; i < NNUE_LAYER2; i++) {
+        output += weights.outputWeights[i] * hidden2[i];
+    }
+    int score = output / NNUE_OUTPUT_SCALE;
+    return score > NNUE_SCORE_LIMIT ? NNUE_SCORE_LIMIT : score < -NNUE_SCORE_LIMIT ? -NNUE_SCORE_LIMIT : score;
+}
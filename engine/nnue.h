@@ -0,0 +1,81 @@
+#ifndef CHESS_NNUE_H
+#define CHESS_NNUE_H
+
+#include "position.h"
+
+#include <cstddef>
+
+// Network shape (HalfKP): every piece but the kings is a feature relative to each side's own
+// king, (king square, piece kind, square) with the board mirrored for black. The features of
+// each perspective sum into NNUE_HIDDEN values; both perspectives, side to move first, feed
+// two small hidden layers and a single output.
+const int NNUE_PIECE_KINDS = 10; // Own pawn to queen, then the opponent's
+const int NNUE_FEATURES = 64 * NNUE_PIECE_KINDS * 64;
+const int NNUE_HIDDEN = 256;
+const int NNUE_LAYER1 = 32;
+const int NNUE_LAYER2 = 32;
+
+// Fixed point: hidden layer sums are shifted right by NNUE_WEIGHT_SHIFT before clipping to
+// 0..127, and the output divided by NNUE_OUTPUT_SCALE gives centipawns
+const int NNUE_WEIGHT_SHIFT = 6;
+const int NNUE_OUTPUT_SCALE = 16;
+
+// Evaluations are clamped to this many centipawns, so they never look like mate scores
+const int NNUE_SCORE_LIMIT = 10000;
+
+// Size of the file header: the magic "CHESSNN1"
+const int NNUE_HEADER_SIZE = 8;
+
+// Weights of one network. The file holds these arrays in this order, little-endian.
+struct NnueWeights {
+    short featureBiases[NNUE_HIDDEN];
+    short featureWeights[NNUE_FEATURES * NNUE_HIDDEN]; // One column of NNUE_HIDDEN per feature
+    int hidden1Biases[NNUE_LAYER1];
+    signed char hidden1Weights[NNUE_LAYER1 * 2 * NNUE_HIDDEN]; // One row of inputs per output
+    int hidden2Biases[NNUE_LAYER2];
+    signed char hidden2Weights[NNUE_LAYER2 * NNUE_LAYER1];
+    int outputBias;
+    signed char outputWeights[NNUE_LAYER2];
+};
+
+// A loaded network, shared read-only by every search thread
+struct NnueNetwork {
+    NnueWeights* weights; // 64-byte aligned, NULL until a file is loaded
+    void* memory;         // Unaligned allocation behind weights
+
+    NnueNetwork() : weights(NULL), memory(NULL) {}
+};
+
+// First layer of the network for one position, both perspectives
+struct NnueAccumulator {
+    alignas(32) short values[2][NNUE_HIDDEN]; // [Color]
+};
+
+// Pick the fastest kernels the CPU supports: AVX2, SSE4.1 or plain C++
+void initNnue();
+
+// Use the kernels of one instruction set ("avx2", "sse4.1" or "scalar"); false if the CPU
+// or the compiler lacks it
+bool selectNnueKernels(const char* name);
+
+// Instruction set of the kernels in use
+const char* nnueKernelName();
+
+// Read a network file; returns false (leaving the network unloaded) if it is missing or malformed
+bool loadNnueNetwork(NnueNetwork& network, const char* path);
+
+// Release the network's weights
+void freeNnueNetwork(NnueNetwork& network);
+
+// Compute both perspectives of a position's accumulator from scratch
+void refreshAccumulator(const NnueNetwork& network, const Position& pos, NnueAccumulator& accumulator);
+
+// Accumulator after makeMove(pos, move, undo), from the one before it: only the columns of the
+// pieces that left or entered a square change, unless a king moved and its side is recomputed
+void updateAccumulator(const NnueNetwork& network, const Position& pos, Move move, const UndoInfo& undo,
+    const NnueAccumulator& parent, NnueAccumulator& child);
+
+// Evaluation in centipawns from the side to move's point of view
+int evaluateNnue(const NnueNetwork& network, const NnueAccumulator& accumulator, bool whiteToMove);
+
+#endif
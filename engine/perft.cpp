@@ -0,0 +1,86 @@
+#include "perft.h"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Count leaf nodes of the legal move tree to the given depth
+unsigned long long perft(Position& pos, int depth) {
+    if (depth == 0) return 1;
+
+    MoveList list;
+    generateMoves(pos, list);
+
+    // Every generated move is legal, so the last ply is just the list length
+    if (depth == 1) return list.count;
+
+    unsigned long long nodes = 0;
+    for (int i = 0; i < list.count; i++) {
+        UndoInfo undo;
+        makeMove(pos, list.moves[i], undo);
+        nodes += perft(pos, depth - 1);
+        unmakeMove(pos, list.moves[i], undo);
+    }
+    return nodes;
+}
+
+// Perft that checks the incrementally updated state after every make and unmake
+unsigned long long perftChecked(Position& pos, int depth, std::atomic<unsigned long long>& failures) {
+    if (depth == 0) return 1;
+
+    MoveList list;
+    generateMoves(pos, list);
+
+    unsigned long long nodes = 0;
+    for (int i = 0; i < list.count; i++) {
+        UndoInfo undo;
+        makeMove(pos, list.moves[i], undo);
+        if (!isIncrementalStateValid(pos)) failures++;
+        nodes += perftChecked(pos, depth - 1, failures);
+        unmakeMove(pos, list.moves[i], undo);
+        if (!isIncrementalStateValid(pos)) failures++;
+    }
+    return nodes;
+}
+
+// Perft with the root moves shared out to worker threads; optionally prints per-move counts
+unsigned long long perftRoot(const Position& root, int depth, int threadCount, bool divide,
+    bool check, std::atomic<unsigned long long>* failures) {
+    MoveList legal;
+    generateMoves(root, legal);
+
+    // Each thread claims the next unsearched root move and works on its own copy of the position
+    std::vector<unsigned long long> counts(legal.count);
+    std::atomic<int> nextMove(0);
+    auto worker = [&]() {
+        Position local = root;
+        for (int i = nextMove++; i < legal.count; i = nextMove++) {
+            UndoInfo undo;
+            makeMove(local, legal.moves[i], undo);
+            if (check && !isIncrementalStateValid(local)) (*failures)++;
+            counts[i] = check ? perftChecked(local, depth - 1, *failures) : perft(local, depth - 1);
+            unmakeMove(local, legal.moves[i], undo);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    unsigned long long nodes = 0;
+    for (int i = 0; i < legal.count; i++) {
+        if (divide) {
+            char text[6];
+            moveToString(legal.moves[i], text);
+            printf("  %s: %llu\n", text, counts[i]);
+        }
+        nodes += counts[i];
+    }
+    return nodes;
+}
@@ -0,0 +1,21 @@
+#ifndef CHESS_PERFT_H
+#define CHESS_PERFT_H
+
+#include "movegen.h"
+
+#include <atomic>
+#include <cstddef>
+
+// Count leaf nodes of the legal move tree to the given depth
+unsigned long long perft(Position& pos, int depth);
+
+// Perft that also makes the last ply's moves and checks the incrementally updated position
+// state after every make and unmake; failures counts the positions that did not match
+unsigned long long perftChecked(Position& pos, int depth, std::atomic<unsigned long long>& failures);
+
+// Perft with the root moves shared out to worker threads; optionally prints per-move counts.
+// With check set it runs perftChecked and adds its failures to *failures.
+unsigned long long perftRoot(const Position& root, int depth, int threadCount, bool divide,
+    bool check = false, std::atomic<unsigned long long>* failures = NULL);
+
+#endif
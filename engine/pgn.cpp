@@ -0,0 +1,151 @@
+#include "pgn.h"
+#include "san.h"
+
+#include <cstring>
+
+// Check if a character separates PGN tokens
+static inline bool isPgnSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Check if a character ends a movetext token
+static inline bool isPgnDelimiter(char c) {
+    return isPgnSpace(c) || c == '{' || c == '}' || c == '(' || c == ')' || c == ';' || c == '[' || c == '$';
+}
+
+// Skip past the next occurrence of a character, or to end
+static inline const char* skipPast(const char* c, const char* end, char stop) {
+    const void* found = memchr(c, stop, end - c);
+    return found != NULL ? (const char*)found + 1 : end;
+}
+
+// Check if [token, tokenEnd) spells text exactly
+static inline bool tokenIs(const char* token, const char* tokenEnd, const char* text) {
+    size_t length = strlen(text);
+    return (size_t)(tokenEnd - token) == length && memcmp(token, text, length) == 0;
+}
+
+// Find the next "[Event" tag at the start of a line at or after text
+const char* findPgnGameStart(const char* text, const char* end) {
+    const char* c = text;
+    while (c < end) {
+        bool lineStart = c == text || c[-1] == '\n';
+        if (lineStart && end - c >= 6 && memcmp(c, "[Event", 6) == 0) {
+            return c;
+        }
+        c = skipPast(c, end, '\n');
+    }
+    return end;
+}
+
+// Read one "[Name "value"]" tag pair; a FEN tag replaces the start position
+static const char* readTagPair(const char* c, const char* end, PgnGame& game) {
+    const char* lineEnd = skipPast(c, end, '\n');
+    if (lineEnd - c >= 6 && memcmp(c, "[FEN \"", 6) == 0) {
+        char fen[MAX_FEN_LENGTH];
+        const char* value = c + 6;
+        int length = 0;
+        while (value + length < lineEnd && value[length] != '"' && length < MAX_FEN_LENGTH - 1) {
+            fen[length] = value[length];
+            length++;
+        }
+        fen[length] = '\0';
+        if (parseFen(game.pos, fen) == NULL) {
+            setStartPosition(game.pos);
+            game.error = c;
+        }
+    }
+    return lineEnd;
+}
+
+// Replay the game at text up to its result; returns where the following game starts
+const char* readPgnGame(const char* text, const char* end, PgnGame& game) {
+    setStartPosition(game.pos);
+    game.plies = 0;
+    game.result = PGN_UNFINISHED;
+    game.error = NULL;
+
+    // Tag pairs
+    const char* c = text;
+    for (;;) {
+        while (c < end && isPgnSpace(*c)) c++;
+        if (c == end || *c != '[') break;
+        c = readTagPair(c, end, game);
+    }
+
+    // Movetext: move numbers, SAN moves, comments, variations and NAGs up to the result
+    while (c < end) {
+        char first = *c;
+        if (isPgnSpace(first)) {
+            c++;
+        }
+        else if (first == '{') {
+            c = skipPast(c, end, '}');
+        }
+        else if (first == ';') {
+            c = skipPast(c, end, '\n');
+        }
+        else if (first == '(') {
+            // Variations nest and may hold comments with parentheses of their own
+            int depth = 0;
+            while (c < end) {
+                if (*c == '{') {
+                    c = skipPast(c, end, '}');
+                    continue;
+                }
+                if (*c == '(') depth++;
+                if (*c == ')' && --depth == 0) {
+                    c++;
+                    break;
+                }
+                c++;
+            }
+        }
+        else if (first == '[') {
+            return c; // Next game's tags: this one had no result
+        }
+        else if (first == '.' || first == ')' || first == '}' || first == '$') {
+            c++;
+            while (c < end && *c >= '0' && *c <= '9') c++;
+        }
+        else {
+            const char* tokenEnd = c;
+            while (tokenEnd < end && !isPgnDelimiter(*tokenEnd)) tokenEnd++;
+
+            if (tokenIs(c, tokenEnd, "1-0")) game.result = PGN_WHITE_WINS;
+            else if (tokenIs(c, tokenEnd, "0-1")) game.result = PGN_BLACK_WINS;
+            else if (tokenIs(c, tokenEnd, "1/2-1/2")) game.result = PGN_DRAW;
+            if (game.result != PGN_UNFINISHED || tokenIs(c, tokenEnd, "*")) {
+                return tokenEnd;
+            }
+
+            // Move number ("12." or "12..."), possibly glued to the move after it
+            const char* digits = c;
+            while (digits < tokenEnd && *digits >= '0' && *digits <= '9') digits++;
+            if (digits > c && digits < tokenEnd && *digits == '.') {
+                c = digits;
+                while (c < tokenEnd && *c == '.') c++;
+                continue;
+            }
+
+            // A move: copied so the parser never reads past the end of the text
+            if (game.error == NULL) {
+                char san[16];
+                int length = (int)(tokenEnd - c) < 15 ? (int)(tokenEnd - c) : 15;
+                memcpy(san, c, length);
+                san[length] = '\0';
+                Move move = parseSan(game.pos, san);
+                if (move == 0) {
+                    game.error = c;
+                }
+                else {
+                    UndoInfo undo;
+                    makeMove(game.pos, move, undo);
+                    game.plies++;
+                }
+            }
+            c = tokenEnd;
+        }
+    }
+    return c;
+}
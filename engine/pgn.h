@@ -0,0 +1,29 @@
+#ifndef CHESS_PGN_H
+#define CHESS_PGN_H
+
+#include "position.h"
+
+// Outcome recorded at the end of a game's movetext
+enum PgnResult {
+    PGN_WHITE_WINS, PGN_BLACK_WINS, PGN_DRAW, PGN_UNFINISHED
+};
+
+// One game replayed from PGN text
+struct PgnGame {
+    Position pos;      // Position after the last legal move
+    int plies;         // Moves replayed
+    PgnResult result;
+    const char* error; // First move that is illegal or unreadable, NULL if every move was legal
+};
+
+// Find the start of the next game (an "[Event" tag at the start of a line) at or after
+// text; returns end if there is none
+const char* findPgnGameStart(const char* text, const char* end);
+
+// Replay the game starting at text: tag pairs (a FEN tag sets the start position), then
+// the movetext up to its result, skipping comments, variations and NAGs. Moves are
+// resolved with the move generator and nothing is allocated, so text may point into a
+// mapped file without a terminator. Returns where the following game starts.
+const char* readPgnGame(const char* text, const char* end, PgnGame& game);
+
+#endif
@@ -0,0 +1,431 @@
+#include "position.h"
+
+#include <cstdio>
+#include <cstring>
+
+const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Castling rights that survive a move touching each square
+static int castlingMask[64];
+
+// Rights lost when a king or rook leaves (or a rook is captured on) its home square
+void initCastlingMask() {
+    for (int square = 0; square < 64; square++) {
+        castlingMask[square] = ALL_CASTLING;
+    }
+    castlingMask[squareOf(0, 4)] &= ~(WHITE_OO | WHITE_OOO);
+    castlingMask[squareOf(0, 7)] &= ~WHITE_OO;
+    castlingMask[squareOf(0, 0)] &= ~WHITE_OOO;
+    castlingMask[squareOf(7, 4)] &= ~(BLACK_OO | BLACK_OOO);
+    castlingMask[squareOf(7, 7)] &= ~BLACK_OO;
+    castlingMask[squareOf(7, 0)] &= ~BLACK_OOO;
+}
+
+// Remove every piece from a position
+void clearPosition(Position& pos) {
+    memset(pos.pieces, 0, sizeof(pos.pieces));
+    memset(pos.colorPieces, 0, sizeof(pos.colorPieces));
+    pos.occupied = 0;
+    for (int square = 0; square < 64; square++) {
+        pos.squares[square] = Piece();
+    }
+
+    pos.whiteToMove = true;
+    pos.castlingRights = 0;
+    pos.epSquare = NO_SQUARE;
+    pos.halfmoveClock = 0;
+    pos.fullmoveNumber = 1;
+    pos.key = 0;
+    pos.pawnKey = 0;
+    pos.psqtScore = 0;
+    pos.phase = 0;
+}
+
+// Set up the standard starting position
+void setStartPosition(Position& pos) {
+    // Clear the board first
+    clearPosition(pos);
+
+    // Set up white pieces (rows 0-1)
+    PieceType backRank[8] = { ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK };
+
+    // White major pieces (row 0)
+    for (int col = 0; col < 8; col++) {
+        putPiece(pos, squareOf(0, col), backRank[col], true);
+    }
+
+    // White pawns (row 1)
+    for (int col = 0; col < 8; col++) {
+        putPiece(pos, squareOf(1, col), PAWN, true);
+    }
+
+    // Set up black pieces (rows 6-7)
+    // Black pawns (row 6)
+    for (int col = 0; col < 8; col++) {
+        putPiece(pos, squareOf(6, col), PAWN, false);
+    }
+
+    // Black major pieces (row 7)
+    for (int col = 0; col < 8; col++) {
+        putPiece(pos, squareOf(7, col), backRank[col], false);
+    }
+
+    pos.castlingRights = ALL_CASTLING;
+    pos.key = computeKey(pos);
+}
+
+// Check if any piece of the given color attacks a square
+bool isSquareAttacked(const Position& pos, int square, bool byWhite) {
+    Color attacker = colorOf(byWhite);
+    const Bitboard* pieces = pos.pieces[attacker];
+
+    return (pawnAttacks[colorOf(!byWhite)][square] & pieces[PAWN]) ||
+        (knightAttacks[square] & pieces[KNIGHT]) ||
+        (kingAttacks[square] & pieces[KING]) ||
+        (rookAttacks(square, pos.occupied) & (pieces[ROOK] | pieces[QUEEN])) ||
+        (bishopAttacks(square, pos.occupied) & (pieces[BISHOP] | pieces[QUEEN]));
+}
+
+// Hash a position from scratch; the incremental key must always equal this
+Key computeKey(const Position& pos) {
+    Key key = 0;
+    Bitboard occupied = pos.occupied;
+    while (occupied) {
+        int square = popLsb(occupied);
+        const Piece& piece = pos.squares[square];
+        key ^= pieceKeys[colorOf(piece.isWhite)][piece.type][square];
+    }
+
+    key ^= castlingKeys[pos.castlingRights];
+    if (pos.epSquare != NO_SQUARE) {
+        key ^= epFileKeys[pos.epSquare % 8];
+    }
+    if (!pos.whiteToMove) {
+        key ^= sideKey;
+    }
+    return key;
+}
+
+// Check the incrementally updated key, pawn key, piece-square score and phase against a recount
+bool isIncrementalStateValid(const Position& pos) {
+    Key pawnKey = 0;
+    Score psqtScore = 0;
+    int phase = 0;
+    Bitboard occupied = pos.occupied;
+    while (occupied) {
+        int square = popLsb(occupied);
+        const Piece& piece = pos.squares[square];
+        psqtScore += pieceSquareScores[colorOf(piece.isWhite)][piece.type][square];
+        phase += PHASE_WEIGHTS[piece.type];
+        if (piece.type == PAWN) pawnKey ^= pieceKeys[colorOf(piece.isWhite)][PAWN][square];
+    }
+    return pos.key == computeKey(pos) && pos.pawnKey == pawnKey && pos.psqtScore == psqtScore && pos.phase == phase;
+}
+
+// Pieces of both colors attacking a square, with sliders seeing through the given occupancy
+Bitboard attackersTo(const Position& pos, int square, Bitboard occupied) {
+    const Bitboard (*pieces)[6] = pos.pieces;
+    return (pawnAttacks[BLACK][square] & pieces[WHITE][PAWN]) |
+        (pawnAttacks[WHITE][square] & pieces[BLACK][PAWN]) |
+        (knightAttacks[square] & (pieces[WHITE][KNIGHT] | pieces[BLACK][KNIGHT])) |
+        (kingAttacks[square] & (pieces[WHITE][KING] | pieces[BLACK][KING])) |
+        (rookAttacks(square, occupied) &
+            (pieces[WHITE][ROOK] | pieces[BLACK][ROOK] | pieces[WHITE][QUEEN] | pieces[BLACK][QUEEN])) |
+        (bishopAttacks(square, occupied) &
+            (pieces[WHITE][BISHOP] | pieces[BLACK][BISHOP] | pieces[WHITE][QUEEN] | pieces[BLACK][QUEEN]));
+}
+
+// Apply a move to the position, saving what unmakeMove needs to take it back
+void makeMove(Position& pos, Move move, UndoInfo& undo) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    MoveFlag flag = moveFlag(move);
+    Piece piece = pos.squares[from];
+
+    undo.captured = pos.squares[to];
+    undo.castlingRights = pos.castlingRights;
+    undo.epSquare = pos.epSquare;
+    undo.halfmoveClock = pos.halfmoveClock;
+    undo.key = pos.key;
+
+    pos.halfmoveClock++;
+    if (pos.epSquare != NO_SQUARE) {
+        pos.key ^= epFileKeys[pos.epSquare % 8];
+        pos.epSquare = NO_SQUARE;
+    }
+
+    if (flag == CASTLING) {
+        // King moves two squares toward the rook, which jumps over it
+        int row = from / 8;
+        bool kingSide = to > from;
+        movePiece(pos, from, to);
+        movePiece(pos, squareOf(row, kingSide ? 7 : 0), squareOf(row, kingSide ? 5 : 3));
+    }
+    else if (flag == EN_PASSANT) {
+        int capturedSquare = piece.isWhite ? to - 8 : to + 8;
+        undo.captured = pos.squares[capturedSquare];
+        removePiece(pos, capturedSquare);
+        movePiece(pos, from, to);
+        pos.halfmoveClock = 0;
+    }
+    else {
+        if (undo.captured.type != EMPTY) {
+            removePiece(pos, to);
+            pos.halfmoveClock = 0;
+        }
+        removePiece(pos, from);
+        putPiece(pos, to, flag == PROMOTION ? movePromotion(move) : piece.type, piece.isWhite);
+
+        if (piece.type == PAWN) {
+            pos.halfmoveClock = 0;
+
+            // Only record an en passant square that an enemy pawn can actually use
+            if ((from ^ to) == 16 &&
+                (pawnAttacks[colorOf(piece.isWhite)][(from + to) / 2] & pos.pieces[colorOf(!piece.isWhite)][PAWN])) {
+                pos.epSquare = (from + to) / 2;
+                pos.key ^= epFileKeys[pos.epSquare % 8];
+            }
+        }
+    }
+
+    int rights = pos.castlingRights & castlingMask[from] & castlingMask[to];
+    if (rights != pos.castlingRights) {
+        pos.key ^= castlingKeys[pos.castlingRights] ^ castlingKeys[rights];
+        pos.castlingRights = rights;
+    }
+
+    if (!pos.whiteToMove) {
+        pos.fullmoveNumber++;
+    }
+    pos.whiteToMove = !pos.whiteToMove;
+    pos.key ^= sideKey;
+}
+
+// Take back a move applied by makeMove
+void unmakeMove(Position& pos, Move move, const UndoInfo& undo) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    MoveFlag flag = moveFlag(move);
+
+    pos.whiteToMove = !pos.whiteToMove;
+    if (!pos.whiteToMove) {
+        pos.fullmoveNumber--;
+    }
+    pos.castlingRights = undo.castlingRights;
+    pos.epSquare = undo.epSquare;
+    pos.halfmoveClock = undo.halfmoveClock;
+
+    if (flag == CASTLING) {
+        int row = from / 8;
+        bool kingSide = to > from;
+        movePiece(pos, squareOf(row, kingSide ? 5 : 3), squareOf(row, kingSide ? 7 : 0));
+        movePiece(pos, to, from);
+    }
+    else if (flag == EN_PASSANT) {
+        movePiece(pos, to, from);
+        putPiece(pos, pos.whiteToMove ? to - 8 : to + 8, PAWN, !pos.whiteToMove);
+    }
+    else {
+        Piece piece = pos.squares[to];
+        removePiece(pos, to);
+        putPiece(pos, from, flag == PROMOTION ? PAWN : piece.type, piece.isWhite);
+        if (undo.captured.type != EMPTY) {
+            putPiece(pos, to, undo.captured.type, undo.captured.isWhite);
+        }
+    }
+
+    // The piece moves above XOR the key back piecewise; restore it exactly
+    pos.key = undo.key;
+}
+
+// Pass the turn without moving (for null-move pruning); not legal when in check
+void makeNullMove(Position& pos, UndoInfo& undo) {
+    undo.captured = Piece();
+    undo.castlingRights = pos.castlingRights;
+    undo.epSquare = pos.epSquare;
+    undo.halfmoveClock = pos.halfmoveClock;
+    undo.key = pos.key;
+
+    if (pos.epSquare != NO_SQUARE) {
+        pos.key ^= epFileKeys[pos.epSquare % 8];
+        pos.epSquare = NO_SQUARE;
+    }
+    pos.halfmoveClock++;
+    pos.whiteToMove = !pos.whiteToMove;
+    pos.key ^= sideKey;
+}
+
+// Take back a null move
+void unmakeNullMove(Position& pos, const UndoInfo& undo) {
+    pos.whiteToMove = !pos.whiteToMove;
+    pos.epSquare = undo.epSquare;
+    pos.halfmoveClock = undo.halfmoveClock;
+    pos.key = undo.key;
+}
+
+// Write a move in coordinate notation ("e2e4", "e7e8q")
+void moveToString(Move move, char* out) {
+    const char promotionChars[4] = { 'n', 'b', 'r', 'q' };
+    out[0] = 'a' + moveFrom(move) % 8;
+    out[1] = '1' + moveFrom(move) / 8;
+    out[2] = 'a' + moveTo(move) % 8;
+    out[3] = '1' + moveTo(move) / 8;
+    out[4] = moveFlag(move) == PROMOTION ? promotionChars[(move >> 12) & 3] : '\0';
+    out[5] = '\0';
+}
+
+// Piece letters in FEN, indexed by PieceType
+static const char PIECE_CHARS[] = "prnbqk";
+
+// Skip spaces and tabs between FEN fields
+static inline const char* skipBlanks(const char* text) {
+    while (*text == ' ' || *text == '\t') text++;
+    return text;
+}
+
+// Read an optional non-negative counter field; leaves value alone if there is none
+static inline const char* parseCounter(const char* text, int& value) {
+    const char* field = skipBlanks(text);
+    if (*field < '0' || *field > '9') return text;
+    int number = 0;
+    while (*field >= '0' && *field <= '9') {
+        number = number * 10 + (*field++ - '0');
+    }
+    value = number;
+    return field;
+}
+
+// Parse the FEN at the start of text into pos, in place and without allocating. The
+// castling, en passant and move counter fields may be left out, as in EPD. Returns the
+// text after the last field read, or NULL on malformed input (pos is then unspecified).
+const char* parseFen(Position& pos, const char* text) {
+    clearPosition(pos);
+    const char* c = skipBlanks(text);
+
+    // Piece placement, rank 8 first; every rank must add up to eight files
+    int row = 7, col = 0;
+    for (; *c != ' ' && *c != '\t' && *c != '\0'; c++) {
+        if (*c == '/') {
+            if (col != 8 || row == 0) return NULL;
+            row--;
+            col = 0;
+        }
+        else if (*c >= '1' && *c <= '8') {
+            col += *c - '0';
+            if (col > 8) return NULL;
+        }
+        else {
+            const char* found = strchr(PIECE_CHARS, *c | 0x20);
+            if (found == NULL || !isValidSquare(row, col)) return NULL;
+            putPiece(pos, squareOf(row, col), (PieceType)(found - PIECE_CHARS), *c < 'a');
+            col++;
+        }
+    }
+    if (row != 0 || col != 8) return NULL;
+
+    // Pawns never stand on the first or last rank
+    if ((pos.pieces[WHITE][PAWN] | pos.pieces[BLACK][PAWN]) & 0xFF000000000000FFULL) return NULL;
+
+    // Side to move
+    c = skipBlanks(c);
+    if (*c != 'w' && *c != 'b') return NULL;
+    pos.whiteToMove = *c++ == 'w';
+
+    // Castling rights, "-" for none
+    const char* field = skipBlanks(c);
+    if (*field == '-') {
+        c = field + 1;
+    }
+    else {
+        for (; *field == 'K' || *field == 'Q' || *field == 'k' || *field == 'q'; field++) {
+            pos.castlingRights |= *field == 'K' ? WHITE_OO : *field == 'Q' ? WHITE_OOO : *field == 'k' ? BLACK_OO : BLACK_OOO;
+            c = field + 1;
+        }
+    }
+
+    // Keep only the rights whose king and rook still stand on their home squares
+    const int homeSquares[6] = { squareOf(0, 4), squareOf(0, 7), squareOf(0, 0),
+        squareOf(7, 4), squareOf(7, 7), squareOf(7, 0) };
+    for (int i = 0; i < 6; i++) {
+        Piece piece = pos.squares[homeSquares[i]];
+        if (piece.type != (i % 3 == 0 ? KING : ROOK) || piece.isWhite != (i < 3)) {
+            pos.castlingRights &= castlingMask[homeSquares[i]];
+        }
+    }
+
+    // En passant target, kept only if it could follow a double step (the square and the one the
+    // pawn came from empty, the enemy pawn just beyond it) and a pawn can capture onto it, as
+    // makeMove does
+    field = skipBlanks(c);
+    if (*field == '-') {
+        c = field + 1;
+    }
+    else if (field[0] >= 'a' && field[0] <= 'h' && field[1] >= '1' && field[1] <= '8') {
+        int square = squareOf(field[1] - '1', field[0] - 'a');
+        if (field[1] != (pos.whiteToMove ? '6' : '3')) return NULL;
+        int forward = pos.whiteToMove ? 8 : -8;
+        Bitboard emptySquares = squareBit(square) | squareBit(square + forward);
+        if (!(pos.occupied & emptySquares) &&
+            (pos.pieces[colorOf(!pos.whiteToMove)][PAWN] & squareBit(square - forward)) &&
+            (pawnAttacks[colorOf(!pos.whiteToMove)][square] & pos.pieces[colorOf(pos.whiteToMove)][PAWN])) {
+            pos.epSquare = square;
+        }
+        c = field + 2;
+    }
+
+    c = parseCounter(c, pos.halfmoveClock);
+    c = parseCounter(c, pos.fullmoveNumber);
+    if (pos.fullmoveNumber < 1) pos.fullmoveNumber = 1;
+
+    // putPiece already hashed the pieces
+    pos.key ^= castlingKeys[pos.castlingRights];
+    if (pos.epSquare != NO_SQUARE) pos.key ^= epFileKeys[pos.epSquare % 8];
+    if (!pos.whiteToMove) pos.key ^= sideKey;
+
+    if (popCount(pos.pieces[WHITE][KING]) != 1 || popCount(pos.pieces[BLACK][KING]) != 1) return NULL;
+    return c;
+}
+
+// Set up a position from Forsyth-Edwards Notation; returns false on malformed input
+bool setFromFen(Position& pos, const char* fen) {
+    return parseFen(pos, fen) != NULL;
+}
+
+// Write the position as FEN into out (MAX_FEN_LENGTH chars); returns its length
+int positionToFen(const Position& pos, char* out) {
+    char* c = out;
+    for (int row = 7; row >= 0; row--) {
+        int empty = 0;
+        for (int col = 0; col < 8; col++) {
+            const Piece& piece = pos.squares[squareOf(row, col)];
+            if (piece.type == EMPTY) {
+                empty++;
+                continue;
+            }
+            if (empty > 0) *c++ = (char)('0' + empty);
+            empty = 0;
+            *c++ = piece.isWhite ? (char)(PIECE_CHARS[piece.type] - 0x20) : PIECE_CHARS[piece.type];
+        }
+        if (empty > 0) *c++ = (char)('0' + empty);
+        if (row > 0) *c++ = '/';
+    }
+
+    *c++ = ' ';
+    *c++ = pos.whiteToMove ? 'w' : 'b';
+    *c++ = ' ';
+    if (pos.castlingRights == 0) *c++ = '-';
+    if (pos.castlingRights & WHITE_OO) *c++ = 'K';
+    if (pos.castlingRights & WHITE_OOO) *c++ = 'Q';
+    if (pos.castlingRights & BLACK_OO) *c++ = 'k';
+    if (pos.castlingRights & BLACK_OOO) *c++ = 'q';
+    *c++ = ' ';
+    if (pos.epSquare == NO_SQUARE) {
+        *c++ = '-';
+    }
+    else {
+        *c++ = (char)('a' + pos.epSquare % 8);
+        *c++ = (char)('1' + pos.epSquare / 8);
+    }
+    c += sprintf(c, " %d %d", pos.halfmoveClock, pos.fullmoveNumber);
+    return (int)(c - out);
+}
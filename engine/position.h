@@ -0,0 +1,148 @@
+#ifndef CHESS_POSITION_H
+#define CHESS_POSITION_H
+
+#include "bitboard.h"
+#include "psqt.h"
+#include "zobrist.h"
+
+// Castling right bits
+enum CastlingRight {
+    WHITE_OO = 1, WHITE_OOO = 2, BLACK_OO = 4, BLACK_OOO = 8,
+    ALL_CASTLING = 15
+};
+
+// Position: one bitboard per color and piece type, aggregate occupancy,
+// and a square-indexed mailbox for answering "what is on this square"
+struct Position {
+    Bitboard pieces[2][6];   // [Color][PieceType]
+    Bitboard colorPieces[2]; // All pieces of one color
+    Bitboard occupied;       // All pieces of both colors
+    Piece squares[64];
+
+    bool whiteToMove;
+    int castlingRights; // CastlingRight bits still available
+    int epSquare;       // Square a pawn may capture onto en passant, or NO_SQUARE
+    int halfmoveClock;  // Plies since the last capture or pawn move
+    int fullmoveNumber;
+
+    Key key;     // Zobrist hash, updated incrementally by every piece and state change
+    Key pawnKey; // Zobrist hash of the pawns alone, for the pawn structure cache
+
+    // Material and piece-square score for white and game phase of the pieces on the board,
+    // updated incrementally like the key
+    Score psqtScore;
+    int phase;
+};
+
+// Position fields that make/unmake cannot reconstruct from the move itself
+struct UndoInfo {
+    Piece captured;
+    int castlingRights;
+    int epSquare;
+    int halfmoveClock;
+    Key key;
+};
+
+// FEN of the standard starting position
+extern const char* START_FEN;
+
+// Fill the castling-right update table
+void initCastlingMask();
+
+// Remove every piece from a position
+void clearPosition(Position& pos);
+
+// Set up the standard starting position
+void setStartPosition(Position& pos);
+
+// Longest FEN positionToFen writes, including the terminator
+const int MAX_FEN_LENGTH = 128;
+
+// Parse the FEN at the start of text without allocating; the castling, en passant and
+// counter fields are optional (as in EPD). Castling rights without their king and rook at home
+// are dropped. Returns the text after the FEN, or NULL if malformed (pawns on the first or last
+// rank, an en passant square off the rank a double step passes over).
+const char* parseFen(Position& pos, const char* text);
+
+// Set up a position from Forsyth-Edwards Notation; returns false on malformed input
+bool setFromFen(Position& pos, const char* fen);
+
+// Write the position as FEN; out needs MAX_FEN_LENGTH chars. Returns the length.
+int positionToFen(const Position& pos, char* out);
+
+// Check if any piece of the given color attacks a square
+bool isSquareAttacked(const Position& pos, int square, bool byWhite);
+
+// Hash a position from scratch; the incremental key must always equal this
+Key computeKey(const Position& pos);
+
+// Check the incrementally updated key, pawn key, piece-square score and phase against a
+// recount from the board, for debugging make/unmake
+bool isIncrementalStateValid(const Position& pos);
+
+// Pieces of both colors attacking a square, with sliders seeing through the given occupancy
+Bitboard attackersTo(const Position& pos, int square, Bitboard occupied);
+
+// Apply a move to the position, saving what unmakeMove needs to take it back
+void makeMove(Position& pos, Move move, UndoInfo& undo);
+
+// Take back a move applied by makeMove
+void unmakeMove(Position& pos, Move move, const UndoInfo& undo);
+
+// Pass the turn without moving (for null-move pruning); not legal when in check
+void makeNullMove(Position& pos, UndoInfo& undo);
+
+// Take back a null move
+void unmakeNullMove(Position& pos, const UndoInfo& undo);
+
+// Write a move in coordinate notation ("e2e4", "e7e8q"); out needs 6 chars
+void moveToString(Move move, char* out);
+
+// Place a piece on an empty square
+inline void putPiece(Position& pos, int square, PieceType type, bool isWhite) {
+    Bitboard bit = squareBit(square);
+    pos.pieces[colorOf(isWhite)][type] |= bit;
+    pos.colorPieces[colorOf(isWhite)] |= bit;
+    pos.occupied |= bit;
+    pos.squares[square] = Piece(type, isWhite);
+    pos.key ^= pieceKeys[colorOf(isWhite)][type][square];
+    if (type == PAWN) pos.pawnKey ^= pieceKeys[colorOf(isWhite)][PAWN][square];
+    pos.psqtScore += pieceSquareScores[colorOf(isWhite)][type][square];
+    pos.phase += PHASE_WEIGHTS[type];
+}
+
+// Lift the piece off an occupied square
+inline void removePiece(Position& pos, int square) {
+    Piece piece = pos.squares[square];
+    Bitboard bit = squareBit(square);
+    pos.pieces[colorOf(piece.isWhite)][piece.type] &= ~bit;
+    pos.colorPieces[colorOf(piece.isWhite)] &= ~bit;
+    pos.occupied &= ~bit;
+    pos.squares[square] = Piece();
+    pos.key ^= pieceKeys[colorOf(piece.isWhite)][piece.type][square];
+    if (piece.type == PAWN) pos.pawnKey ^= pieceKeys[colorOf(piece.isWhite)][PAWN][square];
+    pos.psqtScore -= pieceSquareScores[colorOf(piece.isWhite)][piece.type][square];
+    pos.phase -= PHASE_WEIGHTS[piece.type];
+}
+
+// Move a piece, capturing whatever stands on the target square
+inline void movePiece(Position& pos, int from, int to) {
+    Piece piece = pos.squares[from];
+    if (pos.squares[to].type != EMPTY) {
+        removePiece(pos, to);
+    }
+    removePiece(pos, from);
+    putPiece(pos, to, piece.type, piece.isWhite);
+}
+
+// Check if the side to move has its king attacked
+inline bool isInCheck(const Position& pos) {
+    return isSquareAttacked(pos, lsb(pos.pieces[colorOf(pos.whiteToMove)][KING]), !pos.whiteToMove);
+}
+
+// Plies played since the start of the game
+inline int gamePly(const Position& pos) {
+    return (pos.fullmoveNumber - 1) * 2 + (pos.whiteToMove ? 0 : 1);
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef CHESS_PSQT_H
+#define CHESS_PSQT_H
+
+#include "types.h"
+
+// Midgame and endgame values packed into one int, so both are summed with a single add:
+// the endgame value in the high 16 bits, the midgame value (sign-extended) in the low ones
+typedef int Score;
+
+inline Score makeScore(int midgame, int endgame) { return (int)((unsigned)endgame << 16) + midgame; }
+inline int midgameValue(Score score) { return (short)(unsigned)score; }
+inline int endgameValue(Score score) { return (short)(((unsigned)score + 0x8000) >> 16); }
+
+// Game phase of a full set of pieces; a bare board is 0 and pure endgame values apply
+const int MAX_PHASE = 24;
+
+// Contribution of each piece type to the game phase (pawns and kings count as zero)
+extern const int PHASE_WEIGHTS[6];
+
+// Material plus square bonus of every piece, white's positive and black's negative
+extern Score pieceSquareScores[2][6][64]; // [Color][PieceType][square]
+
+// Fill the score table from the per-type midgame and endgame tables
+void initPieceSquareTables();
+
+#endif
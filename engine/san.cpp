@@ -0,0 +1,195 @@
+#include "san.h"
+
+#include <cstring>
+
+// SAN piece letters, indexed by PieceType (pawns have none)
+static const char SAN_PIECE_CHARS[] = " RNBQK";
+
+// Piece type of an upper-case SAN letter, or EMPTY
+static PieceType pieceFromSan(char c) {
+    const char* found = c != ' ' && c != '\0' ? strchr(SAN_PIECE_CHARS, c) : NULL;
+    return found != NULL ? (PieceType)(found - SAN_PIECE_CHARS) : EMPTY;
+}
+
+// Check if a character can be part of a SAN move (check marks and annotations excluded)
+static inline bool isSanChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '=' || c == '-';
+}
+
+// Check that moving a piece from one square to another leaves its own king unattacked
+// (not for castling or en passant, whose extra squares this does not see)
+static bool leavesKingSafe(const Position& pos, int from, int to) {
+    Color us = colorOf(pos.whiteToMove), them = colorOf(!pos.whiteToMove);
+    Bitboard occupied = (pos.occupied ^ squareBit(from)) | squareBit(to);
+    int king = pos.squares[from].type == KING ? to : lsb(pos.pieces[us][KING]);
+    return (attackersTo(pos, king, occupied) & pos.colorPieces[them] & ~squareBit(to)) == 0;
+}
+
+// Index of a promotion piece in a move's promotion field, or -1 if a pawn cannot promote to it
+static int promotionIndex(PieceType type) {
+    for (int i = 0; i < 4; i++) {
+        if (PROMOTION_TYPES[i] == type) return i;
+    }
+    return -1;
+}
+
+// Find the legal move written in Standard Algebraic Notation; 0 if none or ambiguous
+Move parseSan(const Position& pos, const char* text) {
+    // Copy the move, stopping at check marks, annotations or whatever follows it
+    char san[16];
+    int length = 0;
+    while (isSanChar(text[length]) && length < 15) {
+        san[length] = text[length];
+        length++;
+    }
+    san[length] = '\0';
+
+    // Castling, written with the letter O or the digit zero
+    bool kingSide = strcmp(san, "O-O") == 0 || strcmp(san, "0-0") == 0;
+    bool queenSide = strcmp(san, "O-O-O") == 0 || strcmp(san, "0-0-0") == 0;
+    if (kingSide || queenSide) {
+        MoveList moves;
+        generateMoves(pos, moves);
+        for (int i = 0; i < moves.count; i++) {
+            if (moveFlag(moves.moves[i]) == CASTLING && (moveTo(moves.moves[i]) % 8 == 6) == kingSide) {
+                return moves.moves[i];
+            }
+        }
+        return 0;
+    }
+
+    // Moving piece, then promotion from the end: "=Q" or a bare "Q"
+    PieceType piece = PAWN;
+    const char* c = san;
+    if (pieceFromSan(*c) != EMPTY) {
+        piece = pieceFromSan(*c++);
+    }
+    PieceType promotion = EMPTY;
+    int promotionField = 0;
+    if (piece == PAWN && length >= 3 && pieceFromSan(san[length - 1]) != EMPTY) {
+        promotion = pieceFromSan(san[--length]);
+        promotionField = promotionIndex(promotion);
+        if (promotionField < 0) return 0;
+        if (san[length - 1] == '=') length--;
+        san[length] = '\0';
+    }
+
+    // Destination is the last square; anything between piece and square disambiguates
+    const char* end = san + length;
+    if (end - c < 2 || end[-2] < 'a' || end[-2] > 'h' || end[-1] < '1' || end[-1] > '8') {
+        return 0;
+    }
+    int to = squareOf(end[-1] - '1', end[-2] - 'a');
+    int fromFile = -1, fromRank = -1;
+    for (; c < end - 2; c++) {
+        if (*c >= 'a' && *c <= 'h') fromFile = *c - 'a';
+        else if (*c >= '1' && *c <= '8') fromRank = *c - '1';
+        else if (*c != 'x' && *c != '-') return 0;
+    }
+
+    // En passant is rare enough to be matched against the generated moves
+    Color us = colorOf(pos.whiteToMove), them = colorOf(!pos.whiteToMove);
+    if (piece == PAWN && to == pos.epSquare && fromFile != -1 && fromFile != to % 8 && promotion == EMPTY) {
+        MoveList moves;
+        generateMoves(pos, moves);
+        for (int i = 0; i < moves.count; i++) {
+            if (moveFlag(moves.moves[i]) == EN_PASSANT && moveTo(moves.moves[i]) == to &&
+                moveFrom(moves.moves[i]) % 8 == fromFile) {
+                return moves.moves[i];
+            }
+        }
+        return 0;
+    }
+
+    // Squares the piece could come from, ignoring pins
+    if (pos.colorPieces[us] & squareBit(to)) return 0;
+    Bitboard candidates;
+    if (piece == PAWN) {
+        // No pawn moves onto its own first rank, and there is no square behind it to come from
+        if (to / 8 == (pos.whiteToMove ? 0 : 7)) return 0;
+        int forward = pos.whiteToMove ? 8 : -8;
+        Bitboard pawns = pos.pieces[us][PAWN];
+        if (fromFile != -1 && fromFile != to % 8) {
+            if (!(pos.colorPieces[them] & squareBit(to))) return 0;
+            candidates = pawnAttacks[them][to] & pawns;
+        }
+        else if (pos.squares[to].type != EMPTY) {
+            return 0;
+        }
+        else {
+            candidates = squareBit(to - forward) & pawns;
+            if (!candidates && to / 8 == (pos.whiteToMove ? 3 : 4) && pos.squares[to - forward].type == EMPTY) {
+                candidates = squareBit(to - 2 * forward) & pawns;
+            }
+        }
+        if ((to / 8 == (pos.whiteToMove ? 7 : 0)) != (promotion != EMPTY)) return 0;
+    }
+    else {
+        candidates = pieceAttacks(piece, to, pos.occupied) & pos.pieces[us][piece];
+    }
+
+    // Exactly one candidate must fit the disambiguation and keep its king safe
+    Move match = 0;
+    while (candidates) {
+        int from = popLsb(candidates);
+        if (fromFile != -1 && from % 8 != fromFile) continue;
+        if (fromRank != -1 && from / 8 != fromRank) continue;
+        if (!leavesKingSafe(pos, from, to)) continue;
+        if (match != 0) return 0;
+        match = promotion != EMPTY ? encodeMove(from, to, PROMOTION, promotionField) : encodeMove(from, to);
+    }
+    return match;
+}
+
+// Write a legal move in Standard Algebraic Notation with a check or mate mark
+void moveToSan(const Position& pos, Move move, char* out) {
+    int from = moveFrom(move), to = moveTo(move);
+    PieceType piece = pos.squares[from].type;
+    bool capture = pos.squares[to].type != EMPTY || moveFlag(move) == EN_PASSANT;
+    char* c = out;
+
+    if (moveFlag(move) == CASTLING) {
+        strcpy(c, to % 8 == 6 ? "O-O" : "O-O-O");
+        c += strlen(c);
+    }
+    else {
+        if (piece == PAWN) {
+            if (capture) *c++ = (char)('a' + from % 8);
+        }
+        else {
+            *c++ = SAN_PIECE_CHARS[piece];
+
+            // Name the file, else the rank, else both if another such piece reaches the square
+            MoveList moves;
+            generateMoves(pos, moves);
+            bool ambiguous = false, sameFile = false, sameRank = false;
+            for (int i = 0; i < moves.count; i++) {
+                int other = moveFrom(moves.moves[i]);
+                if (other == from || moveTo(moves.moves[i]) != to || pos.squares[other].type != piece) continue;
+                ambiguous = true;
+                sameFile |= other % 8 == from % 8;
+                sameRank |= other / 8 == from / 8;
+            }
+            if (ambiguous && (!sameFile || sameRank)) *c++ = (char)('a' + from % 8);
+            if (ambiguous && sameFile) *c++ = (char)('1' + from / 8);
+        }
+        if (capture) *c++ = 'x';
+        *c++ = (char)('a' + to % 8);
+        *c++ = (char)('1' + to / 8);
+        if (moveFlag(move) == PROMOTION) {
+            *c++ = '=';
+            *c++ = SAN_PIECE_CHARS[movePromotion(move)];
+        }
+    }
+
+    // Check or mate after the move
+    Position after = pos;
+    UndoInfo undo;
+    makeMove(after, move, undo);
+    if (isInCheck(after)) {
+        MoveList replies;
+        generateMoves(after, replies);
+        *c++ = replies.count == 0 ? '#' : '+';
+    }
+    *c = '\0';
+}
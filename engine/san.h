@@ -0,0 +1,19 @@
+#ifndef CHESS_SAN_H
+#define CHESS_SAN_H
+
+#include "movegen.h"
+
+// Longest SAN moveToSan writes ("Qa1xb2+" style plus promotion), including the terminator
+const int MAX_SAN_LENGTH = 10;
+
+// Find the legal move written in Standard Algebraic Notation ("Nf3", "exd5", "O-O",
+// "e8=Q+", "R1a3") at the start of text; it ends at the first character that cannot be part
+// of a move, so check marks and annotations are ignored. Returns 0 if no legal move matches
+// or the text is ambiguous.
+Move parseSan(const Position& pos, const char* text);
+
+// Write a legal move in Standard Algebraic Notation with a check or mate mark; out needs
+// MAX_SAN_LENGTH chars
+void moveToSan(const Position& pos, Move move, char* out);
+
+#endif
@@ -0,0 +1,523 @@
+#include "search.h"
+#include "evaluate.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// State shared by every thread of one search
+struct SearchShared {
+    TranspositionTable* tt;
+    std::atomic<bool>* stop;               // Caller's abort request
+    std::atomic<bool> abort;               // Raised on stop, on a limit, or when the main thread is done
+    std::atomic<unsigned long long> nodes; // Nodes flushed by all threads
+    SearchLimits limits;
+    Clock::time_point start;
+};
+
+// Per-thread search state: its own position copy and move ordering tables
+struct SearchThread {
+    SearchShared* shared;
+    int id; // 0 is the main thread
+    Position pos;
+    std::vector<Key> keys; // Keys from the start of the game up to the current node
+    Move killers[MAX_PLY][2];
+    int history[2][64][64];
+    Move pv[MAX_PLY + 1][MAX_PLY + 1];
+    int pvLength[MAX_PLY + 1];
+    unsigned long long nodes;
+    unsigned long long flushedNodes; // Part of nodes already added to shared->nodes
+    int selDepth;
+    const NnueNetwork* network;             // Evaluates in place of evaluate() when set
+    NnueAccumulator accumulators[MAX_PLY + 1]; // Its first layer for the position at each ply
+    PawnTable pawnTable;                    // Pawn structure terms of the formations seen so far
+};
+
+// Move ordering score bands
+const int TT_MOVE_SCORE = 1 << 30;
+const int CAPTURE_SCORE = 1 << 24;
+const int KILLER_SCORE = 1 << 22;
+
+// Milliseconds since the search started
+static long long elapsedMs(const SearchShared& shared) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - shared.start).count();
+}
+
+// Publish this thread's node count and raise abort on a stop request or once the time or
+// node limit runs out; polled every 2048 nodes
+static void checkLimits(SearchThread& thread) {
+    SearchShared& shared = *thread.shared;
+    unsigned long long pending = thread.nodes - thread.flushedNodes;
+    unsigned long long total = shared.nodes.fetch_add(pending, std::memory_order_relaxed) + pending;
+    thread.flushedNodes = thread.nodes;
+
+    const SearchLimits& limits = shared.limits;
+    if (shared.stop->load(std::memory_order_relaxed) ||
+        (limits.moveTimeMs > 0 && elapsedMs(shared) >= limits.moveTimeMs) ||
+        (limits.nodes > 0 && total >= limits.nodes)) {
+        shared.abort.store(true, std::memory_order_relaxed);
+    }
+}
+
+static inline bool isStopped(const SearchThread& thread) {
+    return thread.shared->abort.load(std::memory_order_relaxed);
+}
+
+// Mate scores are stored relative to the node, not the root, so they stay valid in other lines
+static inline int scoreToTT(int score, int ply) {
+    return score > MATE_BOUND ? score + ply : score < -MATE_BOUND ? score - ply : score;
+}
+
+static inline int scoreFromTT(int score, int ply) {
+    return score > MATE_BOUND ? score - ply : score < -MATE_BOUND ? score + ply : score;
+}
+
+// Check if the current position occurred before since the last irreversible move
+static bool isRepetition(const SearchThread& thread) {
+    int last = (int)thread.keys.size() - 1;
+    int limit = thread.pos.halfmoveClock < last ? thread.pos.halfmoveClock : last;
+    for (int back = 4; back <= limit; back += 2) {
+        if (thread.keys[last - back] == thread.pos.key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Search score of a tablebase value at a node: mates count from the root like found ones
+static inline int tablebaseScore(unsigned char value, int ply) {
+    if (isTablebaseWin(value)) return MATE_SCORE - ply - tablebasePlies(value);
+    if (isTablebaseLoss(value)) return -MATE_SCORE + ply + tablebasePlies(value);
+    return 0;
+}
+
+static inline bool isCapture(const Position& pos, Move move) {
+    return pos.squares[moveTo(move)].type != EMPTY || moveFlag(move) == EN_PASSANT;
+}
+
+// Score moves for ordering: hash move, captures by MVV-LVA, promotions, killers, history
+static void scoreMoves(const SearchThread& thread, const MoveList& list, Move ttMove, int ply, int* scores) {
+    const Position& pos = thread.pos;
+    for (int i = 0; i < list.count; i++) {
+        Move move = list.moves[i];
+        if (move == ttMove) {
+            scores[i] = TT_MOVE_SCORE;
+        }
+        else if (isCapture(pos, move)) {
+            PieceType victim = moveFlag(move) == EN_PASSANT ? PAWN : pos.squares[moveTo(move)].type;
+            scores[i] = CAPTURE_SCORE + PIECE_VALUES[victim] * 8 - PIECE_VALUES[pos.squares[moveFrom(move)].type] / 16;
+        }
+        else if (moveFlag(move) == PROMOTION) {
+            scores[i] = CAPTURE_SCORE + (movePromotion(move) == QUEEN ? 7000 : -KILLER_SCORE);
+        }
+        else if (ply < MAX_PLY && move == thread.killers[ply][0]) {
+            scores[i] = KILLER_SCORE + 1;
+        }
+        else if (ply < MAX_PLY && move == thread.killers[ply][1]) {
+            scores[i] = KILLER_SCORE;
+        }
+        else {
+            scores[i] = thread.history[colorOf(pos.whiteToMove)][moveFrom(move)][moveTo(move)];
+        }
+    }
+}
+
+// Swap the best-scored remaining move into slot index
+static inline Move pickMove(MoveList& list, int* scores, int index) {
+    int best = index;
+    for (int i = index + 1; i < list.count; i++) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    Move move = list.moves[best];
+    int score = scores[best];
+    list.moves[best] = list.moves[index];
+    scores[best] = scores[index];
+    list.moves[index] = move;
+    scores[index] = score;
+    return move;
+}
+
+// Reward a quiet move that caused a beta cutoff
+static void updateQuietStats(SearchThread& thread, Move move, int depth, int ply) {
+    if (thread.killers[ply][0] != move) {
+        thread.killers[ply][1] = thread.killers[ply][0];
+        thread.killers[ply][0] = move;
+    }
+    int& entry = thread.history[colorOf(thread.pos.whiteToMove)][moveFrom(move)][moveTo(move)];
+    entry += depth * depth;
+    if (entry > KILLER_SCORE / 2) {
+        // Keep history below the killer band by halving the whole table
+        for (int c = 0; c < 2; c++) {
+            for (int from = 0; from < 64; from++) {
+                for (int to = 0; to < 64; to++) {
+                    thread.history[c][from][to] /= 2;
+                }
+            }
+        }
+    }
+}
+
+// Make a move at ply, bringing the network's accumulator along for the child
+static inline void playMove(SearchThread& thread, Move move, UndoInfo& undo, int ply) {
+    makeMove(thread.pos, move, undo);
+    thread.keys.push_back(thread.pos.key);
+    if (thread.network != NULL) {
+        updateAccumulator(*thread.network, thread.pos, move, undo, thread.accumulators[ply], thread.accumulators[ply + 1]);
+    }
+}
+
+// Static evaluation of the position at ply: the network's when one is loaded
+static inline int staticEval(SearchThread& thread, int ply) {
+    if (thread.network != NULL) {
+        return evaluateNnue(*thread.network, thread.accumulators[ply], thread.pos.whiteToMove);
+    }
+    return evaluate(thread.pos, thread.pawnTable);
+}
+
+static inline void undoMove(SearchThread& thread, Move move, const UndoInfo& undo) {
+    thread.keys.pop_back();
+    unmakeMove(thread.pos, move, undo);
+}
+
+// Search captures only until the position is quiet, standing pat on the static eval
+static int quiescence(SearchThread& thread, int alpha, int beta, int ply) {
+    thread.nodes++;
+    if ((thread.nodes & 2047) == 0) checkLimits(thread);
+    if (isStopped(thread)) return 0;
+    if (ply > thread.selDepth) thread.selDepth = ply;
+
+    bool inCheck = isInCheck(thread.pos);
+    if (ply >= MAX_PLY) return inCheck ? 0 : staticEval(thread, ply);
+
+    // In check every evasion is searched and there is no stand-pat
+    int bestScore = -INFINITE_SCORE;
+    if (!inCheck) {
+        bestScore = staticEval(thread, ply);
+        if (bestScore >= beta) return bestScore;
+        if (bestScore > alpha) alpha = bestScore;
+    }
+
+    MoveList list;
+    if (inCheck) {
+        generateMoves(thread.pos, list);
+        if (list.count == 0) return -MATE_SCORE + ply;
+    }
+    else {
+        generateCaptures(thread.pos, list);
+    }
+
+    int scores[256];
+    scoreMoves(thread, list, 0, MAX_PLY, scores);
+    for (int i = 0; i < list.count; i++) {
+        Move move = pickMove(list, scores, i);
+        UndoInfo undo;
+        playMove(thread, move, undo, ply);
+        int score = -quiescence(thread, -beta, -alpha, ply + 1);
+        undoMove(thread, move, undo);
+
+        if (isStopped(thread)) return 0;
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                if (score >= beta) break;
+                alpha = score;
+            }
+        }
+    }
+    return bestScore;
+}
+
+// Principal-variation alpha-beta search; pvNode is true for nodes searched with an open window
+static int alphaBeta(SearchThread& thread, int alpha, int beta, int depth, int ply, bool pvNode, bool allowNull) {
+    Position& pos = thread.pos;
+    thread.pvLength[ply] = ply;
+
+    if (depth <= 0) return quiescence(thread, alpha, beta, ply);
+
+    thread.nodes++;
+    if ((thread.nodes & 2047) == 0) checkLimits(thread);
+    if (isStopped(thread)) return 0;
+    if (ply > thread.selDepth) thread.selDepth = ply;
+
+    bool rootNode = ply == 0;
+    if (!rootNode) {
+        if (pos.halfmoveClock >= 100 || isRepetition(thread)) return 0;
+        if (ply >= MAX_PLY) return staticEval(thread, ply);
+
+        // Mate distance pruning: no line from here can beat a mate already found closer to the root
+        alpha = alpha > -MATE_SCORE + ply ? alpha : -MATE_SCORE + ply;
+        beta = beta < MATE_SCORE - ply - 1 ? beta : MATE_SCORE - ply - 1;
+        if (alpha >= beta) return alpha;
+
+        // Endgame tablebases know the exact result
+        const Tablebases* tablebases = thread.shared->limits.tablebases;
+        unsigned char value;
+        if (tablebases != NULL && popCount(pos.occupied) <= tablebases->maxPieces &&
+            probeTablebase(*tablebases, pos, value)) {
+            return tablebaseScore(value, ply);
+        }
+    }
+
+    // Transposition table cutoff outside the principal variation
+    TranspositionTable& tt = *thread.shared->tt;
+    TTEntry entry;
+    Move ttMove = 0;
+    if (probeTT(tt, pos.key, entry)) {
+        ttMove = entry.move;
+        int ttScore = scoreFromTT(entry.score, ply);
+        if (!pvNode && entry.depth >= depth &&
+            (entry.bound == BOUND_EXACT ||
+                (entry.bound == BOUND_LOWER && ttScore >= beta) ||
+                (entry.bound == BOUND_UPPER && ttScore <= alpha))) {
+            return ttScore;
+        }
+    }
+
+    bool inCheck = isInCheck(pos);
+    if (inCheck) depth++;
+
+    // Null move pruning: if passing still fails high, a real move will too
+    if (!pvNode && allowNull && !inCheck && depth >= 3 &&
+        (pos.colorPieces[colorOf(pos.whiteToMove)] & ~pos.pieces[colorOf(pos.whiteToMove)][PAWN] &
+            ~pos.pieces[colorOf(pos.whiteToMove)][KING]) &&
+        staticEval(thread, ply) >= beta) {
+        UndoInfo undo;
+        makeNullMove(pos, undo);
+        if (thread.network != NULL) thread.accumulators[ply + 1] = thread.accumulators[ply];
+        thread.keys.push_back(pos.key);
+        int score = -alphaBeta(thread, -beta, -beta + 1, depth - 3, ply + 1, false, false);
+        thread.keys.pop_back();
+        unmakeNullMove(pos, undo);
+
+        if (isStopped(thread)) return 0;
+        if (score >= beta) return score >= MATE_BOUND ? beta : score;
+    }
+
+    MoveList list;
+    generateMoves(pos, list);
+    if (list.count == 0) {
+        return inCheck ? -MATE_SCORE + ply : 0;
+    }
+
+    int scores[256];
+    scoreMoves(thread, list, ttMove, ply, scores);
+
+    int bestScore = -INFINITE_SCORE;
+    Move bestMove = 0;
+    int originalAlpha = alpha;
+
+    for (int i = 0; i < list.count; i++) {
+        Move move = pickMove(list, scores, i);
+        bool quiet = !isCapture(pos, move) && moveFlag(move) != PROMOTION;
+
+        UndoInfo undo;
+        playMove(thread, move, undo, ply);
+
+        int score;
+        if (i == 0) {
+            score = -alphaBeta(thread, -beta, -alpha, depth - 1, ply + 1, pvNode, true);
+        }
+        else {
+            // Late quiet moves are first searched shallower with a null window
+            int reduction = 0;
+            if (quiet && depth >= 3 && i >= 3 && !inCheck && !isInCheck(pos)) {
+                reduction = i >= 8 ? 2 : 1;
+            }
+            score = -alphaBeta(thread, -alpha - 1, -alpha, depth - 1 - reduction, ply + 1, false, true);
+            if (score > alpha && reduction > 0) {
+                score = -alphaBeta(thread, -alpha - 1, -alpha, depth - 1, ply + 1, false, true);
+            }
+            if (score > alpha && score < beta) {
+                score = -alphaBeta(thread, -beta, -alpha, depth - 1, ply + 1, true, true);
+            }
+        }
+        undoMove(thread, move, undo);
+
+        if (isStopped(thread)) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (score > alpha) {
+                alpha = score;
+
+                // Extend the principal variation with the child's line
+                thread.pv[ply][ply] = move;
+                for (int j = ply + 1; j < thread.pvLength[ply + 1]; j++) {
+                    thread.pv[ply][j] = thread.pv[ply + 1][j];
+                }
+                thread.pvLength[ply] = thread.pvLength[ply + 1];
+
+                if (score >= beta) {
+                    if (quiet) updateQuietStats(thread, move, depth, ply);
+                    break;
+                }
+            }
+        }
+    }
+
+    Bound bound = bestScore >= beta ? BOUND_LOWER : bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER;
+    storeTT(tt, pos.key, bestMove, scoreToTT(bestScore, ply), 0, depth, bound);
+    return bestScore;
+}
+
+// Helper thread depth schedule: helper i skips depth d when ((d + SKIP_PHASE[j]) / SKIP_SIZE[j])
+// is odd, with j = (i - 1) % 20, so helpers spread over neighbouring depths and fill the table
+// with entries the main thread will need next instead of duplicating its tree
+static const int SKIP_SIZE[20] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+static const int SKIP_PHASE[20] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+// Allocate a thread's state with its own copy of the root and the game history
+static SearchThread* createSearchThread(SearchShared& shared, int id, const Position& root,
+    const Key* history, int historyCount) {
+    SearchThread* thread = new SearchThread();
+    thread->shared = &shared;
+    thread->id = id;
+    thread->pos = root;
+    thread->keys.reserve(historyCount + MAX_PLY + 1);
+    thread->keys.assign(history, history + historyCount);
+    thread->keys.push_back(root.key);
+    memset(thread->killers, 0, sizeof(thread->killers));
+    memset(thread->history, 0, sizeof(thread->history));
+    thread->nodes = 0;
+    thread->flushedNodes = 0;
+    thread->selDepth = 0;
+    clearPawnTable(thread->pawnTable);
+    thread->network = shared.limits.network != NULL && shared.limits.network->weights != NULL ?
+        shared.limits.network : NULL;
+    if (thread->network != NULL) {
+        refreshAccumulator(*thread->network, root, thread->accumulators[0]);
+    }
+    return thread;
+}
+
+// Helper thread loop: iterative deepening on its own schedule until the main thread aborts
+static void helperSearch(SearchThread* thread) {
+    int skip = (thread->id - 1) % 20;
+    for (int depth = 1; depth < MAX_PLY && !isStopped(*thread); depth++) {
+        if (((depth + SKIP_PHASE[skip]) / SKIP_SIZE[skip]) % 2 != 0) continue;
+        thread->selDepth = 0;
+        alphaBeta(*thread, -INFINITE_SCORE, INFINITE_SCORE, depth, 0, true, false);
+    }
+}
+
+// Principal-variation alpha-beta search with iterative deepening
+SearchResult searchPosition(const Position& root, const Key* history, int historyCount,
+    const SearchLimits& limits, TranspositionTable& tt, std::atomic<bool>& stop,
+    SearchReport report, void* reportContext) {
+    SearchShared shared;
+    shared.tt = &tt;
+    shared.stop = &stop;
+    shared.abort.store(stop.load());
+    shared.nodes.store(0);
+    shared.limits = limits;
+    shared.start = Clock::now();
+    newSearchGeneration(tt);
+
+    SearchResult result;
+    result.bestMove = 0;
+    result.score = 0;
+    result.depth = 0;
+
+    MoveList rootMoves;
+    generateMoves(root, rootMoves);
+    if (rootMoves.count > 0) {
+        result.bestMove = rootMoves.moves[0];
+    }
+
+    int threadCount = limits.threads > 1 && rootMoves.count > 0 ? limits.threads : 1;
+    std::vector<SearchThread*> threads;
+    for (int id = 0; id < threadCount; id++) {
+        threads.push_back(createSearchThread(shared, id, root, history, historyCount));
+    }
+    SearchThread* thread = threads[0];
+
+    std::vector<std::thread> helpers;
+    for (int id = 1; id < threadCount; id++) {
+        helpers.emplace_back(helperSearch, threads[id]);
+    }
+
+    int maxDepth = limits.depth > 0 && limits.depth < MAX_PLY ? limits.depth : MAX_PLY - 1;
+    for (int depth = 1; depth <= maxDepth && rootMoves.count > 0; depth++) {
+        thread->selDepth = 0;
+        int score = alphaBeta(*thread, -INFINITE_SCORE, INFINITE_SCORE, depth, 0, true, false);
+
+        // A stopped iteration is incomplete; keep the last full one
+        if (isStopped(*thread) && depth > 1) break;
+
+        result.score = score;
+        result.depth = depth;
+        if (thread->pvLength[0] > 0) {
+            result.bestMove = thread->pv[0][0];
+        }
+
+        if (report) {
+            SearchInfo info;
+            info.depth = depth;
+            info.selDepth = thread->selDepth;
+            info.score = score;
+            info.nodes = shared.nodes.load(std::memory_order_relaxed) + thread->nodes - thread->flushedNodes;
+            info.timeMs = elapsedMs(shared);
+            info.nps = info.nodes * 1000 / (info.timeMs > 0 ? info.timeMs : 1);
+            info.hashfull = hashfullTT(tt);
+            info.pvLength = thread->pvLength[0];
+            for (int i = 0; i < info.pvLength; i++) {
+                info.pv[i] = thread->pv[0][i];
+            }
+            report(info, reportContext);
+        }
+
+        // Stop early once a forced mate is found within the searched depth (a longer
+        // tablebase mate may still be beaten) or the time is mostly used
+        if ((score > MATE_BOUND || score < -MATE_BOUND) && MATE_SCORE - abs(score) <= depth) break;
+        if (limits.moveTimeMs > 0 && elapsedMs(shared) * 2 > limits.moveTimeMs) break;
+        if (isStopped(*thread)) break;
+    }
+
+    // The main thread decides when the search is over; wind the helpers down with it
+    shared.abort.store(true);
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    result.nodes = 0;
+    result.pawnProbes = 0;
+    result.pawnHits = 0;
+    for (SearchThread* searcher : threads) {
+        result.nodes += searcher->nodes;
+        result.pawnProbes += searcher->pawnTable.probes;
+        result.pawnHits += searcher->pawnTable.hits;
+        delete searcher;
+    }
+    result.timeMs = elapsedMs(shared);
+    return result;
+}
+
+// Write an iteration report as a UCI-style "info" line
+void formatSearchInfo(const SearchInfo& info, char* out, int size) {
+    int length;
+    if (info.score > MATE_BOUND) {
+        length = snprintf(out, size, "info depth %d seldepth %d score mate %d", info.depth, info.selDepth,
+            (MATE_SCORE - info.score + 1) / 2);
+    }
+    else if (info.score < -MATE_BOUND) {
+        length = snprintf(out, size, "info depth %d seldepth %d score mate -%d", info.depth, info.selDepth,
+            (MATE_SCORE + info.score) / 2);
+    }
+    else {
+        length = snprintf(out, size, "info depth %d seldepth %d score cp %d", info.depth, info.selDepth, info.score);
+    }
+    length += snprintf(out + length, size > length ? size - length : 0,
+        " nodes %llu nps %llu hashfull %d time %lld pv", info.nodes, info.nps, info.hashfull, info.timeMs);
+
+    for (int i = 0; i < info.pvLength && length + 7 < size; i++) {
+        char text[6];
+        moveToString(info.pv[i], text);
+        length += snprintf(out + length, size - length, " %s", text);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef CHESS_SEARCH_H
+#define CHESS_SEARCH_H
+
+#include "movegen.h"
+#include "nnue.h"
+#include "tablebase.h"
+#include "tt.h"
+
+#include <atomic>
+
+const int MAX_PLY = 128;
+const int MATE_SCORE = 32000;
+const int INFINITE_SCORE = 32001;
+const int MATE_BOUND = MATE_SCORE - MAX_PLY - TB_MAX_PLIES; // Scores beyond this are forced mates, found or from a tablebase
+
+// Limits for one search; zero means no limit
+struct SearchLimits {
+    int depth;
+    int moveTimeMs;
+    unsigned long long nodes; // Total over all threads
+    int threads;              // Lazy SMP threads sharing the transposition table
+    const Tablebases* tablebases; // Probed for exact results once few pieces are left, or NULL
+    const NnueNetwork* network;   // Evaluates positions in place of evaluate(), or NULL
+
+    SearchLimits() : depth(0), moveTimeMs(0), nodes(0), threads(1), tablebases(NULL), network(NULL) {}
+};
+
+// Progress report for one completed iteration
+struct SearchInfo {
+    int depth;
+    int selDepth;
+    int score;
+    unsigned long long nodes;
+    long long timeMs;
+    unsigned long long nps;
+    int hashfull;
+    Move pv[MAX_PLY];
+    int pvLength;
+};
+
+// Called after every completed iteration with the current best line
+typedef void (*SearchReport)(const SearchInfo& info, void* context);
+
+// Final outcome of a search
+struct SearchResult {
+    Move bestMove; // 0 when the root has no legal moves
+    int score;
+    int depth;
+    unsigned long long nodes;
+    long long timeMs;
+    unsigned long long pawnProbes; // Pawn table lookups over all threads
+    unsigned long long pawnHits;   // Lookups that found the formation's terms cached
+};
+
+// Principal-variation alpha-beta search with iterative deepening. history holds the
+// keys of the positions played before root (oldest first) for repetition detection.
+// With limits.threads > 1, helper threads search the same root through the shared
+// table (Lazy SMP); the result and reports come from the main thread.
+// Setting stop makes the search return its last completed iteration within milliseconds.
+SearchResult searchPosition(const Position& root, const Key* history, int historyCount,
+    const SearchLimits& limits, TranspositionTable& tt, std::atomic<bool>& stop,
+    SearchReport report = NULL, void* reportContext = NULL);
+
+// Write an iteration report as a UCI-style "info" line
+void formatSearchInfo(const SearchInfo& info, char* out, int size);
+
+#endif
@@ -0,0 +1,422 @@
+#include "tablebase.h"
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+// File header magic, followed by the material name and the positions per side to move
+static const char TB_MAGIC[8] = { 'C', 'H', 'E', 'S', 'S', 'T', 'B', '1' };
+
+// Piece letters of a material name, in table order
+static const char TABLE_LETTERS[] = "QRBNP";
+static const PieceType TABLE_ORDER[5] = { QUEEN, ROOK, BISHOP, KNIGHT, PAWN };
+
+// Values used to decide which side is stronger, indexed by PieceType
+static const int STRENGTH[6] = { 1, 5, 3, 3, 9, 0 };
+
+// Squares of the a1-d1-d4 triangle holding the white king in pawnless tables, and the
+// index of each square of it
+static const int TRIANGLE_SQUARES[10] = { 0, 1, 2, 3, 9, 10, 11, 18, 19, 27 };
+static const int TRIANGLE_OFFSET[4] = { 0, 4, 7, 9 };
+
+// Position of a piece type in table order
+static inline int tableRank(PieceType type) {
+    for (int i = 0; i < 5; i++) {
+        if (TABLE_ORDER[i] == type) return i;
+    }
+    return 5;
+}
+
+// Strength of one side's pieces: material, then piece count, then the pieces in table order
+static int compareSides(const PieceType* a, int countA, const PieceType* b, int countB) {
+    int strengthA = 0, strengthB = 0;
+    for (int i = 0; i < countA; i++) strengthA += STRENGTH[a[i]];
+    for (int i = 0; i < countB; i++) strengthB += STRENGTH[b[i]];
+    if (strengthA != strengthB) return strengthA - strengthB;
+    if (countA != countB) return countA - countB;
+    for (int i = 0; i < countA; i++) {
+        if (a[i] != b[i]) return tableRank(b[i]) - tableRank(a[i]);
+    }
+    return 0;
+}
+
+// Parse a material name, putting the stronger side first
+bool parseTablebaseMaterial(const char* name, TablebaseMaterial& material) {
+    PieceType sides[2][MAX_TABLEBASE_PIECES];
+    int counts[2] = { 0, 0 };
+    int side = -1;
+    for (const char* c = name; *c != '\0'; c++) {
+        if (*c == 'K') {
+            if (++side > 1) return false;
+            continue;
+        }
+        const char* letter = strchr(TABLE_LETTERS, *c);
+        if (letter == NULL || side < 0 || counts[0] + counts[1] >= MAX_TABLEBASE_PIECES - 2) {
+            return false;
+        }
+        PieceType type = TABLE_ORDER[letter - TABLE_LETTERS];
+
+        // Insertion keeps each side in table order
+        int i = counts[side]++;
+        while (i > 0 && tableRank(sides[side][i - 1]) > tableRank(type)) {
+            sides[side][i] = sides[side][i - 1];
+            i--;
+        }
+        sides[side][i] = type;
+    }
+    if (side != 1) {
+        return false;
+    }
+    int white = compareSides(sides[0], counts[0], sides[1], counts[1]) >= 0 ? 0 : 1;
+
+    material.count = 0;
+    material.hasPawns = false;
+    material.key = 0;
+    char* out = material.name;
+    for (int color = WHITE; color <= BLACK; color++) {
+        int from = color == WHITE ? white : 1 - white;
+        *out++ = 'K';
+        for (int i = 0; i < counts[from]; i++) {
+            PieceType type = sides[from][i];
+            material.types[material.count] = type;
+            material.isWhite[material.count] = color == WHITE;
+            material.count++;
+            material.hasPawns |= type == PAWN;
+            material.key += 1u << (3 * (type + 5 * color));
+            *out++ = TABLE_LETTERS[tableRank(type)];
+        }
+    }
+    *out = '\0';
+
+    material.size = (material.hasPawns ? 32 : 10) * 64;
+    for (int i = 0; i < material.count; i++) {
+        material.size *= material.types[i] == PAWN ? 48 : 64;
+    }
+    return true;
+}
+
+// Piece counts per color and type, 3 bits each
+unsigned materialKey(const Position& pos, bool flip) {
+    // Walks the pieces rather than counting each bitboard: tables hold only a few of them
+    unsigned key = 0;
+    Bitboard pieces = pos.occupied & ~(pos.pieces[WHITE][KING] | pos.pieces[BLACK][KING]);
+    while (pieces) {
+        const Piece& piece = pos.squares[popLsb(pieces)];
+        int color = piece.isWhite != flip ? WHITE : BLACK;
+        key += 1u << (3 * (piece.type + 5 * color));
+    }
+    return key;
+}
+
+// Index of the white king square (already moved into its region) and the other squares
+static inline size_t squaresIndex(const TablebaseMaterial& material, const int* squares) {
+    int king = squares[0];
+    size_t index = material.hasPawns ? (king >> 3) * 4 + (king & 7) : TRIANGLE_OFFSET[king >> 3] + (king & 7) - (king >> 3);
+    index = index * 64 + squares[1];
+    for (int i = 0; i < material.count; i++) {
+        index = material.types[i] == PAWN ? index * 48 + squares[2 + i] - 8 : index * 64 + squares[2 + i];
+    }
+    return index;
+}
+
+// Put identical pieces in square order, so swapping them does not change the index
+static inline void sortIdenticalPieces(const TablebaseMaterial& material, int* squares) {
+    for (int i = 1; i < material.count; i++) {
+        for (int j = i; j > 0 && material.types[j] == material.types[j - 1] && material.isWhite[j] == material.isWhite[j - 1] &&
+            squares[2 + j] < squares[1 + j]; j--) {
+            int square = squares[2 + j];
+            squares[2 + j] = squares[1 + j];
+            squares[1 + j] = square;
+        }
+    }
+}
+
+// Index of a position: its squares are mirrored so the white king stands on files a-d, and
+// for pawnless tables in the a1-d1-d4 triangle
+size_t tablebaseIndex(const TablebaseMaterial& material, const Position& pos, bool flip) {
+    int us = flip ? BLACK : WHITE; // Color playing the table's white pieces
+    int mirror = flip ? 56 : 0;
+    int count = material.count + 2;
+    int squares[MAX_TABLEBASE_PIECES];
+    squares[0] = lsb(pos.pieces[us][KING]) ^ mirror;
+    squares[1] = lsb(pos.pieces[us ^ 1][KING]) ^ mirror;
+
+    // Identical pieces come one after another, so each takes the next square of its set
+    Bitboard left = 0;
+    for (int i = 0; i < material.count; i++) {
+        if (i == 0 || material.types[i] != material.types[i - 1] || material.isWhite[i] != material.isWhite[i - 1]) {
+            left = pos.pieces[material.isWhite[i] ? us : us ^ 1][material.types[i]];
+        }
+        squares[2 + i] = popLsb(left) ^ mirror;
+    }
+
+    if ((squares[0] & 7) > 3) {
+        for (int i = 0; i < count; i++) squares[i] ^= 7;
+    }
+    if (!material.hasPawns && squares[0] > 31) {
+        for (int i = 0; i < count; i++) squares[i] ^= 56;
+    }
+    bool transpose = !material.hasPawns && (squares[0] >> 3) > (squares[0] & 7);
+    if (transpose) {
+        for (int i = 0; i < count; i++) squares[i] = ((squares[i] & 7) << 3) | (squares[i] >> 3);
+    }
+    sortIdenticalPieces(material, squares);
+    size_t index = squaresIndex(material, squares);
+
+    // A king on the diagonal stays there when mirrored along it; the lower index stands for both
+    if (!material.hasPawns && (squares[0] >> 3) == (squares[0] & 7)) {
+        for (int i = 0; i < count; i++) squares[i] = ((squares[i] & 7) << 3) | (squares[i] >> 3);
+        sortIdenticalPieces(material, squares);
+        size_t mirrored = squaresIndex(material, squares);
+        if (mirrored < index) index = mirrored;
+    }
+    return pos.whiteToMove != flip ? index : index + material.size;
+}
+
+// Set up the position at an index
+bool setTablebasePosition(const TablebaseMaterial& material, size_t index, Position& pos) {
+    bool whiteToMove = index < material.size;
+    size_t rest = whiteToMove ? index : index - material.size;
+
+    int squares[MAX_TABLEBASE_PIECES];
+    for (int i = material.count - 1; i >= 0; i--) {
+        if (material.types[i] == PAWN) {
+            squares[2 + i] = (int)(rest % 48) + 8;
+            rest /= 48;
+        }
+        else {
+            squares[2 + i] = (int)(rest % 64);
+            rest /= 64;
+        }
+    }
+    squares[1] = (int)(rest % 64);
+    rest /= 64;
+    squares[0] = material.hasPawns ? (int)(rest / 4) * 8 + (int)(rest % 4) : TRIANGLE_SQUARES[rest];
+
+    Bitboard used = 0;
+    for (int i = 0; i < material.count + 2; i++) {
+        if (used & squareBit(squares[i])) return false;
+        used |= squareBit(squares[i]);
+    }
+    if (kingAttacks[squares[0]] & squareBit(squares[1])) {
+        return false;
+    }
+
+    clearPosition(pos);
+    putPiece(pos, squares[0], KING, true);
+    putPiece(pos, squares[1], KING, false);
+    for (int i = 0; i < material.count; i++) {
+        putPiece(pos, squares[2 + i], material.types[i], material.isWhite[i]);
+    }
+    pos.whiteToMove = whiteToMove;
+    pos.key = computeKey(pos);
+
+    // Mirror images and swapped identical pieces are stored once, at the index the position maps to
+    return !isSquareAttacked(pos, squares[whiteToMove ? 1 : 0], whiteToMove) && tablebaseIndex(material, pos, false) == index;
+}
+
+// Write the header and values
+bool writeTablebase(const char* path, const TablebaseMaterial& material, const unsigned char* values) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    unsigned char header[TB_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, TB_MAGIC, sizeof(TB_MAGIC));
+    memcpy(header + 8, material.name, strlen(material.name));
+    for (int i = 0; i < 8; i++) {
+        header[24 + i] = (unsigned char)((unsigned long long)material.size >> (8 * i)); // Little-endian
+    }
+    bool written = fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+        fwrite(values, 1, 2 * material.size, file) == 2 * material.size;
+    return fclose(file) == 0 && written;
+}
+
+// Table for a material key, or NULL
+static const TablebaseFile* findTablebase(const Tablebases& tablebases, unsigned key) {
+    for (unsigned slot = (key * 2654435761u) >> 22;; slot = (slot + 1) % TABLEBASE_SLOTS) {
+        const TablebaseFile* table = tablebases.slots[slot];
+        if (table == NULL || table->material.key == key) return table;
+    }
+}
+
+// Map a table, check its header against its size, and file it under its material key
+bool addTablebase(Tablebases& tablebases, const char* path) {
+    TablebaseFile* table = new TablebaseFile();
+    const unsigned char* header = NULL;
+    if (openMappedFile(table->file, path) && table->file.size >= (size_t)TB_HEADER_SIZE) {
+        header = (const unsigned char*)table->file.data;
+    }
+
+    char name[MAX_TABLEBASE_PIECES + 1] = "";
+    unsigned long long size = 0;
+    if (header != NULL && memcmp(header, TB_MAGIC, sizeof(TB_MAGIC)) == 0 && memchr(header + 8, '\0', 16) != NULL &&
+        strlen((const char*)header + 8) <= MAX_TABLEBASE_PIECES) {
+        strcpy(name, (const char*)header + 8);
+        for (int i = 0; i < 8; i++) {
+            size |= (unsigned long long)header[24 + i] << (8 * i);
+        }
+    }
+
+    TablebaseMaterial& material = table->material;
+    if (!parseTablebaseMaterial(name, material) || strcmp(name, material.name) != 0 || size != material.size ||
+        table->file.size != TB_HEADER_SIZE + 2 * material.size || tablebases.count >= TABLEBASE_SLOTS / 2 ||
+        findTablebase(tablebases, material.key) != NULL) {
+        closeMappedFile(table->file);
+        delete table;
+        return false;
+    }
+
+    table->values = header + TB_HEADER_SIZE;
+    unsigned slot = (material.key * 2654435761u) >> 22;
+    while (tablebases.slots[slot] != NULL) slot = (slot + 1) % TABLEBASE_SLOTS;
+    tablebases.slots[slot] = table;
+    tablebases.count++;
+    if (material.count + 2 > tablebases.maxPieces) tablebases.maxPieces = material.count + 2;
+    return true;
+}
+
+// Every side a table can have besides its king: up to three pieces in table order
+static int listSides(char sides[][MAX_TABLEBASE_PIECES], const char* prefix, int first, int count) {
+    strcpy(sides[count++], prefix);
+    if ((int)strlen(prefix) == MAX_TABLEBASE_PIECES - 2) {
+        return count;
+    }
+    for (int letter = first; letter < 5; letter++) {
+        char longer[MAX_TABLEBASE_PIECES];
+        sprintf(longer, "%s%c", prefix, TABLE_LETTERS[letter]);
+        count = listSides(sides, longer, letter, count);
+    }
+    return count;
+}
+
+// Try every material with up to MAX_TABLEBASE_PIECES pieces
+int openTablebases(Tablebases& tablebases, const char* directory) {
+    static char sides[64][MAX_TABLEBASE_PIECES];
+    int sideCount = listSides(sides, "", 0, 0);
+
+    int found = 0;
+    for (int white = 0; white < sideCount; white++) {
+        for (int black = 0; black < sideCount; black++) {
+            if (strlen(sides[white]) + strlen(sides[black]) > MAX_TABLEBASE_PIECES - 2) continue;
+            char name[16];
+            sprintf(name, "K%sK%s", sides[white], sides[black]);
+            TablebaseMaterial material;
+            if (!parseTablebaseMaterial(name, material) || strcmp(name, material.name) != 0) continue;
+
+            char path[4096];
+            snprintf(path, sizeof(path), "%s/%s.tb", directory, name);
+            if (addTablebase(tablebases, path)) found++;
+        }
+    }
+    return found;
+}
+
+// Unmap every table
+void closeTablebases(Tablebases& tablebases) {
+    for (int slot = 0; slot < TABLEBASE_SLOTS; slot++) {
+        if (tablebases.slots[slot] != NULL) {
+            closeMappedFile(tablebases.slots[slot]->file);
+            delete tablebases.slots[slot];
+            tablebases.slots[slot] = NULL;
+        }
+    }
+    tablebases.count = 0;
+    tablebases.maxPieces = 0;
+}
+
+// Mover's view of the position after a move
+int tablebaseRank(unsigned char childValue) {
+    if (isTablebaseLoss(childValue)) return 1000 - tablebasePlies(childValue);
+    if (isTablebaseWin(childValue)) return -1000 + tablebasePlies(childValue);
+    return 0;
+}
+
+// A position's own value on the tablebaseRank scale, and back
+static inline int rankOfValue(unsigned char value) {
+    if (isTablebaseWin(value)) return 1001 - tablebasePlies(value);
+    if (isTablebaseLoss(value)) return -1001 + tablebasePlies(value);
+    return 0;
+}
+
+static inline unsigned char valueOfRank(int rank) {
+    if (rank > 0) return (unsigned char)((1001 - rank + 1) / 2);
+    if (rank < 0) return (unsigned char)(TB_LOSS + (rank + 1001) / 2);
+    return TB_DRAW;
+}
+
+// Combine the stored value, which covers every move but en passant captures, with the captures
+static bool addEnPassantCaptures(const Tablebases& tablebases, const Position& pos, unsigned char& value) {
+    MoveList moves;
+    generateMoves(pos, moves);
+    bool otherMoves = false;
+    int best = INT_MIN;
+    for (int i = 0; i < moves.count; i++) {
+        if (moveFlag(moves.moves[i]) != EN_PASSANT) {
+            otherMoves = true;
+            continue;
+        }
+        Position child = pos;
+        UndoInfo undo;
+        makeMove(child, moves.moves[i], undo);
+        unsigned char childValue;
+        if (!probeTablebase(tablebases, child, childValue)) return false;
+        int rank = tablebaseRank(childValue);
+        if (rank > best) best = rank;
+    }
+    if (best == INT_MIN) {
+        return true; // The captures were not legal
+    }
+    if (otherMoves && rankOfValue(value) > best) {
+        best = rankOfValue(value);
+    }
+    value = valueOfRank(best);
+    return true;
+}
+
+// One lookup: material key, table, index, value
+bool probeTablebase(const Tablebases& tablebases, const Position& pos, unsigned char& value) {
+    if (popCount(pos.occupied) > tablebases.maxPieces || pos.castlingRights != 0) {
+        return false;
+    }
+
+    // The colors' halves of the key swap places for the mirrored material
+    bool flip = false;
+    unsigned key = materialKey(pos, false);
+    const TablebaseFile* table = findTablebase(tablebases, key);
+    if (table == NULL) {
+        flip = true;
+        table = findTablebase(tablebases, (key >> 15) | ((key & 0x7fff) << 15));
+        if (table == NULL) return false;
+    }
+    value = table->values[tablebaseIndex(table->material, pos, flip)];
+    if (value == TB_ILLEGAL) {
+        return false;
+    }
+    return !canCaptureEnPassant(pos) || addEnPassantCaptures(tablebases, pos, value);
+}
+
+// Probe every legal move and keep the best ranked one
+Move tablebaseMove(const Tablebases& tablebases, const Position& pos, unsigned char& value) {
+    if (!probeTablebase(tablebases, pos, value)) {
+        return 0;
+    }
+    MoveList moves;
+    generateMoves(pos, moves);
+    Move best = 0;
+    int bestRank = INT_MIN;
+    for (int i = 0; i < moves.count; i++) {
+        Position child = pos;
+        UndoInfo undo;
+        makeMove(child, moves.moves[i], undo);
+        unsigned char childValue;
+        if (!probeTablebase(tablebases, child, childValue)) continue;
+        int rank = tablebaseRank(childValue);
+        if (rank > bestRank) {
+            bestRank = rank;
+            best = moves.moves[i];
+        }
+    }
+    return best;
+}
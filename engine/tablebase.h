@@ -0,0 +1,111 @@
+#ifndef CHESS_TABLEBASE_H
+#define CHESS_TABLEBASE_H
+
+#include "mappedfile.h"
+#include "movegen.h"
+
+// Most pieces, kings included, a table can hold
+const int MAX_TABLEBASE_PIECES = 5;
+
+// Stored value of a position for the side to move: TB_DRAW, 1 to TB_MAX_MATE mates in that
+// many moves, TB_LOSS + n is mated in n moves (TB_LOSS itself is checkmate on the board)
+const unsigned char TB_DRAW = 0;
+const unsigned char TB_LOSS = 128;
+const unsigned char TB_ILLEGAL = 255; // Index that does not describe a legal position
+const int TB_MAX_MATE = 127;
+
+// Longest distance to mate a table can store, in plies
+const int TB_MAX_PLIES = 2 * TB_MAX_MATE - 1;
+
+// Size of the file header: magic, material name and positions per side to move
+const int TB_HEADER_SIZE = 32;
+
+// Material of one table: the pieces besides the kings, white's first, each side ordered
+// queen, rook, bishop, knight, pawn. "KRPKR" is a rook and pawn against a rook; the
+// stronger side is always white, positions with the colors reversed are probed mirrored.
+struct TablebaseMaterial {
+    int count; // Pieces besides the kings
+    PieceType types[MAX_TABLEBASE_PIECES - 2];
+    bool isWhite[MAX_TABLEBASE_PIECES - 2];
+    bool hasPawns;
+    unsigned key; // Piece counts per color and type, as materialKey computes them
+    size_t size;  // Positions per side to move
+    char name[MAX_TABLEBASE_PIECES + 1];
+};
+
+// One mapped table
+struct TablebaseFile {
+    MappedFile file;
+    TablebaseMaterial material;
+    const unsigned char* values; // White to move first, then black to move
+};
+
+// Open-addressed table of tablebases by material key
+const int TABLEBASE_SLOTS = 1024;
+
+// Every table found in a directory, mapped and ready to probe from any thread
+struct Tablebases {
+    TablebaseFile* slots[TABLEBASE_SLOTS];
+    int count;
+    int maxPieces; // Most pieces in any loaded table, 0 when none is loaded
+
+    Tablebases() : count(0), maxPieces(0) {
+        for (int i = 0; i < TABLEBASE_SLOTS; i++) slots[i] = NULL;
+    }
+};
+
+// Parse a material name such as "KBNK" or "KRPKR" (either side may come first, pieces in
+// any order); returns false unless it has two kings and at most MAX_TABLEBASE_PIECES pieces
+bool parseTablebaseMaterial(const char* name, TablebaseMaterial& material);
+
+// Piece counts per color and type of a position, with the colors swapped if flip is set
+unsigned materialKey(const Position& pos, bool flip);
+
+// Index of a position with the table's material (colors swapped if flip is set);
+// symmetric positions share an index
+size_t tablebaseIndex(const TablebaseMaterial& material, const Position& pos, bool flip);
+
+// Set up the position at an index; returns false if it is not legal (pieces on the same
+// square, kings touching or the side not to move in check) or is stored at another index
+bool setTablebasePosition(const TablebaseMaterial& material, size_t index, Position& pos);
+
+// Write a table with 2 * material.size values; returns false if the file cannot be written
+bool writeTablebase(const char* path, const TablebaseMaterial& material, const unsigned char* values);
+
+// Map one table file and make it probeable; returns false if it is missing or malformed
+bool addTablebase(Tablebases& tablebases, const char* path);
+
+// Map every "<material>.tb" table in a directory; returns how many were found
+int openTablebases(Tablebases& tablebases, const char* directory);
+
+// Unmap every table
+void closeTablebases(Tablebases& tablebases);
+
+// Look up the value of a position; false if no table has its material or castling is possible.
+// Tables do not store en passant rights, so a possible en passant capture is probed one move deeper.
+bool probeTablebase(const Tablebases& tablebases, const Position& pos, unsigned char& value);
+
+// Value of the position after a move, from the mover's side: the best move maximizes it.
+// Quicker mates rank above slower ones, draws above losses, and slower losses above quicker ones.
+int tablebaseRank(unsigned char childValue);
+
+// The move that mates fastest, holds the draw or resists longest, or 0 if the position is
+// not in the tables; value receives the position's stored value
+Move tablebaseMove(const Tablebases& tablebases, const Position& pos, unsigned char& value);
+
+// Check if the side to move has a pawn next to the pawn that just made a double step
+inline bool canCaptureEnPassant(const Position& pos) {
+    return pos.epSquare != NO_SQUARE &&
+        (pawnAttacks[colorOf(!pos.whiteToMove)][pos.epSquare] & pos.pieces[colorOf(pos.whiteToMove)][PAWN]) != 0;
+}
+
+// Check if a stored value is a win or a loss for the side to move
+inline bool isTablebaseWin(unsigned char value) { return value >= 1 && value <= TB_MAX_MATE; }
+inline bool isTablebaseLoss(unsigned char value) { return value >= TB_LOSS && value < TB_ILLEGAL; }
+
+// Distance to mate in plies of a won or lost value, 0 for a draw
+inline int tablebasePlies(unsigned char value) {
+    return isTablebaseWin(value) ? 2 * value - 1 : isTablebaseLoss(value) ? 2 * (value - TB_LOSS) : 0;
+}
+
+#endif
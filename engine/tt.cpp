@@ -0,0 +1,137 @@
+#include "tt.h"
+
+#include <cstdlib>
+
+// Data word layout: move 0-15, score 16-31, eval 32-47, depth 48-55, bound 56-57, generation 58-63
+static inline unsigned long long packEntry(Move move, int score, int eval, int depth, Bound bound,
+    unsigned char generation) {
+    return (unsigned long long)move |
+        ((unsigned long long)(unsigned short)score << 16) |
+        ((unsigned long long)(unsigned short)eval << 32) |
+        ((unsigned long long)(unsigned char)depth << 48) |
+        ((unsigned long long)bound << 56) |
+        ((unsigned long long)(generation & 63) << 58);
+}
+
+static inline int entryDepth(unsigned long long data) { return (signed char)(data >> 48); }
+static inline Bound entryBound(unsigned long long data) { return (Bound)((data >> 56) & 3); }
+static inline int entryGeneration(unsigned long long data) { return (int)(data >> 58); }
+
+// Allocate a table of (at most) sizeMb megabytes and clear it; returns false if allocation fails
+bool initTranspositionTable(TranspositionTable& tt, size_t sizeMb) {
+    freeTranspositionTable(tt);
+
+    // Round down to a power of two so the bucket index is a single mask
+    size_t count = 1;
+    while (count * 2 * sizeof(TTBucket) <= sizeMb * 1024 * 1024) {
+        count *= 2;
+    }
+
+    tt.memory = malloc(count * sizeof(TTBucket) + 63);
+    if (!tt.memory) {
+        tt.buckets = NULL;
+        tt.bucketCount = 0;
+        return false;
+    }
+    tt.buckets = (TTBucket*)(((size_t)tt.memory + 63) & ~(size_t)63);
+    tt.bucketCount = count;
+    tt.generation = 0;
+    clearTranspositionTable(tt);
+    return true;
+}
+
+// Release the table's memory
+void freeTranspositionTable(TranspositionTable& tt) {
+    if (tt.memory) {
+        free(tt.memory);
+    }
+    tt.memory = NULL;
+    tt.buckets = NULL;
+    tt.bucketCount = 0;
+}
+
+// Empty every slot
+void clearTranspositionTable(TranspositionTable& tt) {
+    for (size_t i = 0; i < tt.bucketCount; i++) {
+        for (int j = 0; j < TT_BUCKET_SIZE; j++) {
+            tt.buckets[i].slots[j].check.store(0, std::memory_order_relaxed);
+            tt.buckets[i].slots[j].data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// Start a new search: entries from older generations become preferred for replacement
+void newSearchGeneration(TranspositionTable& tt) {
+    tt.generation = (tt.generation + 1) & 63;
+}
+
+// Look up a position; fills entry and returns true on a verified hit
+bool probeTT(const TranspositionTable& tt, Key key, TTEntry& entry) {
+    const TTBucket& bucket = tt.buckets[key & (tt.bucketCount - 1)];
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        unsigned long long data = bucket.slots[i].data.load(std::memory_order_relaxed);
+        unsigned long long check = bucket.slots[i].check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && entryBound(data) != BOUND_NONE) {
+            entry.move = (Move)data;
+            entry.score = (short)(data >> 16);
+            entry.eval = (short)(data >> 32);
+            entry.depth = entryDepth(data);
+            entry.bound = entryBound(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Store a search result, replacing the shallowest or oldest slot in the bucket
+void storeTT(TranspositionTable& tt, Key key, Move move, int score, int eval, int depth, Bound bound) {
+    TTBucket& bucket = tt.buckets[key & (tt.bucketCount - 1)];
+    TTSlot* replace = &bucket.slots[0];
+    int replaceValue = 1 << 30;
+
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        TTSlot& slot = bucket.slots[i];
+        unsigned long long data = slot.data.load(std::memory_order_relaxed);
+        unsigned long long check = slot.check.load(std::memory_order_relaxed);
+
+        // Same position: overwrite in place, keeping the old best move if we have none
+        if ((check ^ data) == key) {
+            if (move == 0) move = (Move)data;
+
+            // A shallower non-exact result must not wipe out a deeper one from this search
+            if (bound != BOUND_EXACT && depth + 4 < entryDepth(data) &&
+                entryGeneration(data) == tt.generation) {
+                return;
+            }
+            replace = &slot;
+            break;
+        }
+
+        // Otherwise prefer the slot that is least deep once its age is counted against it
+        int age = (tt.generation - entryGeneration(data)) & 63;
+        int value = entryBound(data) == BOUND_NONE ? -1000 : entryDepth(data) - 8 * age;
+        if (value < replaceValue) {
+            replaceValue = value;
+            replace = &slot;
+        }
+    }
+
+    unsigned long long data = packEntry(move, score, eval, depth, bound, tt.generation);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+// Approximate fill level in permille, sampled from the first thousand buckets
+int hashfullTT(const TranspositionTable& tt) {
+    size_t sample = tt.bucketCount < 1000 ? tt.bucketCount : 1000;
+    int used = 0;
+    for (size_t i = 0; i < sample; i++) {
+        for (int j = 0; j < TT_BUCKET_SIZE; j++) {
+            unsigned long long data = tt.buckets[i].slots[j].data.load(std::memory_order_relaxed);
+            if (entryBound(data) != BOUND_NONE && entryGeneration(data) == tt.generation) {
+                used++;
+            }
+        }
+    }
+    return sample ? (int)(used * 1000 / (sample * TT_BUCKET_SIZE)) : 0;
+}
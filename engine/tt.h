@@ -0,0 +1,74 @@
+#ifndef CHESS_TT_H
+#define CHESS_TT_H
+
+#include "types.h"
+
+#include <atomic>
+#include <cstddef>
+
+// Kind of bound a stored search score represents
+enum Bound : unsigned char {
+    BOUND_NONE, BOUND_UPPER, BOUND_LOWER, BOUND_EXACT
+};
+
+// Decoded contents of one transposition table slot
+struct TTEntry {
+    Move move;
+    short score;
+    short eval;
+    int depth;
+    Bound bound;
+};
+
+// One slot: the data word and the key XORed with it. A reader that sees a data
+// word from one write and a check word from another gets a key mismatch, so
+// concurrent writers never need a lock.
+struct TTSlot {
+    std::atomic<unsigned long long> check;
+    std::atomic<unsigned long long> data;
+};
+
+// Four slots share one 64-byte cache line
+const int TT_BUCKET_SIZE = 4;
+
+struct TTBucket {
+    TTSlot slots[TT_BUCKET_SIZE];
+};
+
+// Hash table of search results shared by every search thread
+struct TranspositionTable {
+    TTBucket* buckets;
+    size_t bucketCount;       // Power of two
+    void* memory;             // Unaligned allocation behind buckets
+    unsigned char generation; // Bumped every search so stale entries age out
+
+    TranspositionTable() : buckets(NULL), bucketCount(0), memory(NULL), generation(0) {}
+};
+
+// Allocate a table of (at most) sizeMb megabytes and clear it; returns false if allocation fails
+bool initTranspositionTable(TranspositionTable& tt, size_t sizeMb);
+
+// Release the table's memory
+void freeTranspositionTable(TranspositionTable& tt);
+
+// Empty every slot
+void clearTranspositionTable(TranspositionTable& tt);
+
+// Start a new search: entries from older generations become preferred for replacement
+void newSearchGeneration(TranspositionTable& tt);
+
+// Look up a position; fills entry and returns true on a verified hit
+bool probeTT(const TranspositionTable& tt, Key key, TTEntry& entry);
+
+// Store a search result, replacing the shallowest or oldest slot in the bucket
+void storeTT(TranspositionTable& tt, Key key, Move move, int score, int eval, int depth, Bound bound);
+
+// Approximate fill level in permille, sampled from the first thousand buckets
+int hashfullTT(const TranspositionTable& tt);
+
+// Hint the CPU to start loading a position's bucket
+inline void prefetchTT(const TranspositionTable& tt, Key key) {
+    __builtin_prefetch(&tt.buckets[key & (tt.bucketCount - 1)]);
+}
+
+#endif
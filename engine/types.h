@@ -0,0 +1,63 @@
+#ifndef CHESS_TYPES_H
+#define CHESS_TYPES_H
+
+// Chess piece types
+enum PieceType : unsigned char {
+    PAWN, ROOK, KNIGHT, BISHOP, QUEEN, KING, EMPTY
+};
+
+// Side indices for the per-color bitboards
+enum Color {
+    WHITE, BLACK
+};
+
+// Piece structure
+struct Piece {
+    PieceType type;
+    bool isWhite;
+
+    Piece() : type(EMPTY), isWhite(true) {}
+    Piece(PieceType t, bool white) : type(t), isWhite(white) {}
+};
+
+// 64-bit square set, bit index = row * 8 + col (A1 = 0, H8 = 63)
+typedef unsigned long long Bitboard;
+
+// 64-bit Zobrist hash of a position
+typedef unsigned long long Key;
+
+// Square index used when there is no en passant target
+const int NO_SQUARE = -1;
+
+// Move encoding: bits 0-5 from, 6-11 to, 12-13 promotion piece, 14-15 MoveFlag
+typedef unsigned short Move;
+
+enum MoveFlag {
+    NORMAL, PROMOTION, EN_PASSANT, CASTLING
+};
+
+// Square and bit helpers
+inline int squareOf(int row, int col) { return row * 8 + col; }
+inline bool isValidSquare(int row, int col) { return row >= 0 && row < 8 && col >= 0 && col < 8; }
+inline Bitboard squareBit(int square) { return 1ULL << square; }
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+inline int lsb(Bitboard b) { return __builtin_ctzll(b); }
+inline int popLsb(Bitboard& b) {
+    int square = lsb(b);
+    b &= b - 1;
+    return square;
+}
+inline Color colorOf(bool isWhite) { return isWhite ? WHITE : BLACK; }
+
+// Move field accessors
+const PieceType PROMOTION_TYPES[4] = { KNIGHT, BISHOP, ROOK, QUEEN };
+
+inline Move encodeMove(int from, int to, MoveFlag flag = NORMAL, int promotion = 0) {
+    return (Move)(from | (to << 6) | (promotion << 12) | (flag << 14));
+}
+inline int moveFrom(Move move) { return move & 63; }
+inline int moveTo(Move move) { return (move >> 6) & 63; }
+inline PieceType movePromotion(Move move) { return PROMOTION_TYPES[(move >> 12) & 3]; }
+inline MoveFlag moveFlag(Move move) { return (MoveFlag)(move >> 14); }
+
+#endif
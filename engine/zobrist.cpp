@@ -0,0 +1,44 @@
+#include "zobrist.h"
+
+Key pieceKeys[2][6][64];
+Key castlingKeys[16];
+Key epFileKeys[8];
+Key sideKey;
+
+// Xorshift64* step
+static Key nextKey(Key& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+// Fill the key tables from a fixed seed so hashes are stable between runs
+void initZobrist() {
+    Key state = 1070372;
+
+    for (int color = 0; color < 2; color++) {
+        for (int type = 0; type < 6; type++) {
+            for (int square = 0; square < 64; square++) {
+                pieceKeys[color][type][square] = nextKey(state);
+            }
+        }
+    }
+
+    // One key per right; a set of rights hashes as the XOR of its members
+    Key rightKeys[4];
+    for (int i = 0; i < 4; i++) {
+        rightKeys[i] = nextKey(state);
+    }
+    for (int rights = 0; rights < 16; rights++) {
+        castlingKeys[rights] = 0;
+        for (int i = 0; i < 4; i++) {
+            if (rights & (1 << i)) castlingKeys[rights] ^= rightKeys[i];
+        }
+    }
+
+    for (int file = 0; file < 8; file++) {
+        epFileKeys[file] = nextKey(state);
+    }
+    sideKey = nextKey(state);
+}
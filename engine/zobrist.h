@@ -0,0 +1,15 @@
+#ifndef CHESS_ZOBRIST_H
+#define CHESS_ZOBRIST_H
+
+#include "types.h"
+
+// Random keys XORed together to form a position's hash
+extern Key pieceKeys[2][6][64]; // [Color][PieceType][square]
+extern Key castlingKeys[16];    // Indexed by the full CastlingRight bit set
+extern Key epFileKeys[8];       // File of the en passant square
+extern Key sideKey;             // Present when black is to move
+
+// Fill the key tables from a fixed seed so hashes are stable between runs
+void initZobrist();
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef CHESS_RENDER_COMMON_H
+#define CHESS_RENDER_COMMON_H
+
+// OpenGL 1.1 only, so the renderer runs on the stock Windows opengl32 and on Mesa.
+// The Windows GL header needs windows.h first.
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/gl.h>
+
+// Chess board dimensions in world units
+const int BOARD_SIZE = 8;
+const float SQUARE_SIZE = 0.12f;
+const float BOARD_OFFSET = -0.48f;
+
+// Colors
+inline void setColor(float r, float g, float b) {
+    glColor3f(r, g, b);
+}
+
+#endif
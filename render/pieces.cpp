@@ -0,0 +1,948 @@
+#include "pieces.h"
+
+#include <cmath>
+
+// Unit circle points shared by every drawCircle call
+static const int CIRCLE_SEGMENTS = 20;
+static float circleCos[CIRCLE_SEGMENTS + 1];
+static float circleSin[CIRCLE_SEGMENTS + 1];
+
+// Precompute the unit circle used by drawCircle
+static void initCircleTable() {
+    for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
+        float angle = 2.0f * M_PI * i / CIRCLE_SEGMENTS;
+        circleCos[i] = cos(angle);
+        circleSin[i] = sin(angle);
+    }
+}
+
+// Draw a filled or outlined circle
+void drawCircle(float centerX, float centerY, float radius, bool filled) {
+    if (filled) {
+        glBegin(GL_TRIANGLE_FAN);
+        glVertex2f(centerX, centerY);
+        for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
+            glVertex2f(centerX + circleCos[i] * radius,
+                centerY + circleSin[i] * radius);
+        }
+        glEnd();
+    }
+    else {
+        glBegin(GL_LINE_LOOP);
+        for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
+            glVertex2f(centerX + circleCos[i] * radius,
+                centerY + circleSin[i] * radius);
+        }
+        glEnd();
+    }
+}
+
+// Draw a pawn with enhanced design
+static void drawPawn(float x, float y, bool isWhite) {
+    float centerX = x + SQUARE_SIZE / 2;
+    float centerY = y + SQUARE_SIZE / 2;
+    float baseRadius = SQUARE_SIZE / 8;
+
+    // Enhanced color palette with gradients
+    float mainR = isWhite ? 0.98f : 0.12f;
+    float mainG = isWhite ? 0.96f : 0.08f;
+    float mainB = isWhite ? 0.94f : 0.04f;
+
+    float highlightR = isWhite ? 1.0f : 0.25f;
+    float highlightG = isWhite ? 1.0f : 0.20f;
+    float highlightB = isWhite ? 0.98f : 0.15f;
+
+    float shadowR = isWhite ? 0.85f : 0.02f;
+    float shadowG = isWhite ? 0.83f : 0.01f;
+    float shadowB = isWhite ? 0.80f : 0.0f;
+
+    // Base platform with enhanced detail
+    setColor(shadowR, shadowG, shadowB);
+    drawCircle(centerX, centerY - baseRadius * 1.3f, baseRadius * 1.5f, true);
+
+    setColor(mainR, mainG, mainB);
+    drawCircle(centerX, centerY - baseRadius * 1.2f, baseRadius * 1.4f, true);
+
+    // Decorative base ring
+    setColor(highlightR, highlightG, highlightB);
+    glLineWidth(2.5f);
+    drawCircle(centerX, centerY - baseRadius * 1.2f, baseRadius * 1.3f, false);
+
+    // Enhanced base collar with beveled edges
+    setColor(mainR, mainG, mainB);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 1.2f, centerY - baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 1.2f, centerY - baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 1.1f, centerY - baseRadius * 0.7f);
+    glVertex2f(centerX - baseRadius * 1.1f, centerY - baseRadius * 0.7f);
+    glEnd();
+
+    // Shadow detail on collar
+    setColor(shadowR, shadowG, shadowB);
+    glLineWidth(1.5f);
+    glBegin(GL_LINES);
+    glVertex2f(centerX - baseRadius * 1.1f, centerY - baseRadius * 0.9f);
+    glVertex2f(centerX + baseRadius * 1.1f, centerY - baseRadius * 0.9f);
+    glEnd();
+
+    // Lower stem with enhanced cylindrical shape
+    setColor(mainR, mainG, mainB);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 0.65f, centerY - baseRadius * 0.7f);
+    glVertex2f(centerX + baseRadius * 0.65f, centerY - baseRadius * 0.7f);
+    glVertex2f(centerX + baseRadius * 0.75f, centerY + baseRadius * 0.9f);
+    glVertex2f(centerX - baseRadius * 0.75f, centerY + baseRadius * 0.9f);
+    glEnd();
+
+    // Add cylindrical shading
+    setColor(shadowR, shadowG, shadowB);
+    glLineWidth(1.0f);
+    glBegin(GL_LINES);
+    glVertex2f(centerX - baseRadius * 0.5f, centerY - baseRadius * 0.5f);
+    glVertex2f(centerX - baseRadius * 0.6f, centerY + baseRadius * 0.7f);
+    glEnd();
+
+    // Enhanced upper bulb with realistic proportions
+    setColor(highlightR, highlightG, highlightB);
+    drawCircle(centerX, centerY + baseRadius * 0.5f, baseRadius * 1.1f, true);
+
+    setColor(mainR, mainG, mainB);
+    drawCircle(centerX, centerY + baseRadius * 0.4f, baseRadius * 1.0f, true);
+
+    // Decorative ring around bulb
+    setColor(shadowR, shadowG, shadowB);
+    glLineWidth(1.5f);
+    drawCircle(centerX, centerY + baseRadius * 0.4f, baseRadius * 0.9f, false);
+
+    // Enhanced neck with better proportions
+    setColor(mainR, mainG, mainB);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 0.45f, centerY + baseRadius * 1.3f);
+    glVertex2f(centerX + baseRadius * 0.45f, centerY + baseRadius * 1.3f);
+    glVertex2f(centerX + baseRadius * 0.35f, centerY + baseRadius * 1.7f);
+    glVertex2f(centerX - baseRadius * 0.35f, centerY + baseRadius * 1.7f);
+    glEnd();
+
+    // Enhanced head with better shaping
+    setColor(highlightR, highlightG, highlightB);
+    drawCircle(centerX, centerY + baseRadius * 1.9f, baseRadius * 0.85f, true);
+
+    setColor(mainR, mainG, mainB);
+    drawCircle(centerX, centerY + baseRadius * 1.8f, baseRadius * 0.8f, true);
+
+    // Crown-like detail on head
+    setColor(highlightR, highlightG, highlightB);
+    glLineWidth(2.0f);
+    for (int i = 0; i < 6; i++) {
+        float angle = i * 60.0f * M_PI / 180.0f;
+        float x1 = centerX + cos(angle) * baseRadius * 0.6f;
+        float y1 = centerY + baseRadius * 1.8f + sin(angle) * baseRadius * 0.6f;
+        float x2 = centerX + cos(angle) * baseRadius * 0.4f;
+        float y2 = centerY + baseRadius * 1.8f + sin(angle) * baseRadius * 0.4f;
+
+        glBegin(GL_LINES);
+        glVertex2f(x1, y1);
+        glVertex2f(x2, y2);
+        glEnd();
+    }
+
+    // Highlight spot for 3D effect
+    setColor(highlightR, highlightG, highlightB);
+    drawCircle(centerX - baseRadius * 0.25f, centerY + baseRadius * 2.1f, baseRadius * 0.2f, true);
+}
+
+// Draw a rook with enhanced fortress design
+static void drawRook(float x, float y, bool isWhite) {
+    float centerX = x + SQUARE_SIZE / 2;
+    float centerY = y + SQUARE_SIZE / 2;
+    float baseWidth = SQUARE_SIZE / 3;
+    float height = SQUARE_SIZE / 2.5f;
+
+    // Enhanced color palette
+    float mainR = isWhite ? 0.96f : 0.10f;
+    float mainG = isWhite ? 0.94f : 0.07f;
+    float mainB = isWhite ? 0.92f : 0.04f;
+
+    float highlightR = isWhite ? 1.0f : 0.22f;
+    float highlightG = isWhite ? 0.98f : 0.18f;
+    float highlightB = isWhite ? 0.96f : 0.14f;
+
+    float shadowR = isWhite ? 0.82f : 0.02f;
+    float shadowG = isWhite ? 0.80f : 0.01f;
+    float shadowB = isWhite ? 0.78f : 0.0f;
+
+    // Enhanced base platform with stone-like texture
+    setColor(shadowR, shadowG, shadowB);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseWidth * 0.85f, centerY - height * 0.8f);
+    glVertex2f(centerX + baseWidth * 0.85f, centerY - height * 0.8f);
+    glVertex2f(centerX + baseWidth * 0.75f, centerY - height * 0.4f);
+    glVertex2f(centerX - baseWidth * 0.75f, centerY - height * 0.4f);
+    glEnd();
+
+    setColor(mainR, mainG, mainB);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseWidth * 0.8f, centerY - height * 0.7f);
+    glVertex2f(centerX + baseWidth * 0.8f, centerY - height * 0.7f);
+    glVertex2f(centerX + baseWidth * 0.7f, centerY - height * 0.45f);
+    glVertex2f(centerX - baseWidth * 0.7f, centerY - height * 0.45f);
+    glEnd();
+
+    // Stone block pattern on base
+    setColor(shadowR, shadowG, shadowB);
+    glLineWidth(1.5f);
+    for (int i = 0; i < 3; i++) {
+        float lineY = centerY - height * (0.65f - i * 0.1f);
+        glBegin(GL_LINES);
+        glVertex2f(centerX - baseWidth * 0.7f, lineY);
+        glVertex2f(centerX + baseWidth * 0.7f, lineY);
+        glEnd();
+    }
+
+    // Enhanced main tower body with stone texture
+    setColor(mainR, mainG, mainB);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseWidth * 0.58f, centerY - height * 0.45f);
+    glVertex2f(centerX + baseWidth * 0.58f, centerY - height * 0.45f);
+    glVertex2f(centerX + baseWidth * 0.58f, centerY + height * 0.45f);
+    glVertex2f(centerX - baseWidth * 0.58f, centerY + height * 0.45f);
+    glEnd();
+
+    // Add stone block pattern to tower
+    setColor(shadowR, shadowG, shadowB);
+    glLineWidth(1.0f);
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 3; col++) {
+            float blockX = centerX - baseWidth * 0.4f + col * baseWidth * 0.27f;
+            float blockY = centerY - height * 0.2f + row * height * 0.15f;
+
+            glBegin(GL_LINE_LOOP);
+            glVertex2f(blockX - baseWidth * 0.12f, blockY - height * 0.06f);
+            glVertex2f(blockX + baseWidth * 0.12f, blockY - height * 0.06f);
+            glVertex2f(blockX + baseWidth * 0.12f, blockY + height * 0.06f);
+            glVertex2f(blockX - baseWidth * 0.12f, blockY + height * 0.06f);
+            glEnd();
+        }
+    }
+
+    // Enhanced top collar with decorative molding
+    setColor(highlightR, highlightG, highlightB);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseWidth * 0.68f, centerY + height * 0.45f);
+    glVertex2f(centerX + baseWidth * 0.68f, centerY + height * 0.45f);
+    glVertex2f(centerX + baseWidth * 0.68f, centerY + height * 0.65f);
+    glVertex2f(centerX - baseWidth * 0.68f, centerY + height * 0.65f);
+    glEnd();
+
+    // Decorative molding lines
+    setColor(shadowR, shadowG, shadowB);
+    glLineWidth(2.0f);
+    glBegin(GL_LINES);
+    glVertex2f(centerX - baseWidth * 0.65f, centerY + height * 0.5f);
+    glVertex2f(centerX + baseWidth * 0.65f, centerY + height * 0.5f);
+    glVertex2f(centerX - baseWidth * 0.65f, centerY + height * 0.6f);
+    glVertex2f(centerX + baseWidth * 0.65f, centerY + height * 0.6f);
+    glEnd();
+
+    // Enhanced battlements with detailed crenellations
+    setColor(mainR, mainG, mainB);
+    float merlonWidth = baseWidth * 0.16f;
+    for (int i = 0; i < 5; i++) {
+        float merlonX = centerX - baseWidth * 0.5f + i * (baseWidth / 4);
+
+        // Main merlon
+        glBegin(GL_QUADS);
+        glVertex2f(merlonX - merlonWidth / 2, centerY + height * 0.65f);
+        glVertex2f(merlonX + merlonWidth / 2, centerY + height * 0.65f);
+        glVertex2f(merlonX + merlonWidth / 2, centerY + height * 0.9f);
+        glVertex2f(merlonX - merlonWidth / 2, centerY + height * 0.9f);
+        glEnd();
+
+        // Highlight on merlon top
+        setColor(highlightR, highlightG, highlightB);
+        glLineWidth(2.0f);
+        glBegin(GL_LINES);
+        glVertex2f(merlonX - merlonWidth / 2, centerY + height * 0.9f);
+        glVertex2f(merlonX + merlonWidth / 2, centerY + height * 0.9f);
+        glEnd();
+
+        setColor(mainR, mainG, mainB);
+    }
+
+    // Enhanced castle gate with arched design
+    setColor(shadowR * 0.5f, shadowG * 0.5f, shadowB * 0.5f);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseWidth * 0.22f, centerY - height * 0.25f);
+    glVertex2f(centerX + baseWidth * 0.22f, centerY - height * 0.25f);
+    glVertex2f(centerX + baseWidth * 0.22f, centerY + height * 0.15f);
+    glVertex2f(centerX - baseWidth * 0.22f, centerY + height * 0.15f);
+    glEnd();
+
+    // Arched top of gate with enhanced detail
+    for (int i = 0; i <= 10; i++) {
+        float t = i / 10.0f;
+        float angle = M_PI * t;
+        float archX = centerX + cos(angle + M_PI) * baseWidth * 0.22f;
+        float archY = centerY + height * 0.15f + sin(angle) * baseWidth * 0.15f;
+
+        if (i < 10) {
+            float nextT = (i + 1) / 10.0f;
+            float nextAngle = M_PI * nextT;
+            float nextArchX = centerX + cos(nextAngle + M_PI) * baseWidth * 0.22f;
+            float nextArchY = centerY + height * 0.15f + sin(nextAngle) * baseWidth * 0.15f;
+
+            glLineWidth(3.0f);
+            glBegin(GL_LINES);
+            glVertex2f(archX, archY);
+            glVertex2f(nextArchX, nextArchY);
+            glEnd();
+        }
+    }
+
+    // Portcullis bars
+    setColor(shadowR * 0.3f, shadowG * 0.3f, shadowB * 0.3f);
+    glLineWidth(2.0f);
+    for (int i = 0; i < 4; i++) {
+        float barX = centerX - baseWidth * 0.15f + i * baseWidth * 0.1f;
+        glBegin(GL_LINES);
+        glVertex2f(barX, centerY - height * 0.2f);
+        glVertex2f(barX, centerY + height * 0.1f);
+        glEnd();
+    }
+
+    // Enhanced window slits with depth
+    setColor(shadowR * 0.4f, shadowG * 0.4f, shadowB * 0.4f);
+    glLineWidth(4.0f);
+
+    // Left window slit
+    glBegin(GL_LINES);
+    glVertex2f(centerX - baseWidth * 0.4f, centerY + height * 0.1f);
+    glVertex2f(centerX - baseWidth * 0.4f, centerY + height * 0.35f);
+    glEnd();
+
+    // Right window slit
+    glBegin(GL_LINES);
+    glVertex2f(centerX + baseWidth * 0.4f, centerY + height * 0.1f);
+    glVertex2f(centerX + baseWidth * 0.4f, centerY + height * 0.35f);
+    glEnd();
+
+    // Window slit depth effect
+    setColor(shadowR * 0.7f, shadowG * 0.7f, shadowB * 0.7f);
+    glLineWidth(2.0f);
+    glBegin(GL_LINES);
+    glVertex2f(centerX - baseWidth * 0.38f, centerY + height * 0.12f);
+    glVertex2f(centerX - baseWidth * 0.38f, centerY + height * 0.33f);
+    glVertex2f(centerX + baseWidth * 0.38f, centerY + height * 0.12f);
+    glVertex2f(centerX + baseWidth * 0.38f, centerY + height * 0.33f);
+    glEnd();
+}
+
+// Draw a bishop with enhanced ecclesiastical design
+static void drawBishop(float x, float y, bool isWhite) {
+    float centerX = x + SQUARE_SIZE / 2;
+    float centerY = y + SQUARE_SIZE / 2;
+    float baseRadius = SQUARE_SIZE / 8;
+
+    // Enhanced color palette
+    float mainR = isWhite ? 0.97f : 0.11f;
+    float mainG = isWhite ? 0.95f : 0.08f;
+    float mainB = isWhite ? 0.93f : 0.05f;
+
+    float highlightR = isWhite ? 1.0f : 0.24f;
+    float highlightG = isWhite ? 0.98f : 0.20f;
+    float highlightB = isWhite ? 0.96f : 0.16f;
+
+    float shadowR = isWhite ? 0.84f : 0.03f;
+    float shadowG = isWhite ? 0.82f : 0.02f;
+    float shadowB = isWhite ? 0.80f : 0.01f;
+
+    // Enhanced base platform with ornate design
+    setColor(shadowR, shadowG, shadowB);
+    drawCircle(centerX, centerY - baseRadius * 1.3f, baseRadius * 1.4f, true);
+
+    setColor(mainR, mainG, mainB);
+    drawCircle(centerX, centerY - baseRadius * 1.2f, baseRadius * 1.3f, true);
+
+    // Ornate base ring with ecclesiastical pattern
+    setColor(highlightR, highlightG, highlightB);
+    glLineWidth(3.0f);
+    drawCircle(centerX, centerY - baseRadius * 1.2f, baseRadius * 1.2f, false);
+
+    // Cross pattern on base
+    glLineWidth(2.0f);
+    glBegin(GL_LINES);
+    // Horizontal cross arms
+    glVertex2f(centerX - baseRadius * 0.8f, centerY - baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 0.8f, centerY - baseRadius * 1.2f);
+    // Vertical cross arm
+    glVertex2f(centerX, centerY - baseRadius * 1.6f);
+    glVertex2f(centerX, centerY - baseRadius * 0.8f);
+    glEnd();
+
+    // Enhanced base collar with decorative molding
+    setColor(mainR, mainG, mainB);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 1.05f, centerY - baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 1.05f, centerY - baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 0.95f, centerY - baseRadius * 0.7f);
+    glVertex2f(centerX - baseRadius * 0.95f, centerY - baseRadius * 0.7f);
+    glEnd();
+
+    // Decorative bands on collar
+    setColor(highlightR, highlightG, highlightB);
+    glLineWidth(2.0f);
+    for (int i = 0; i < 3; i++) {
+        float bandY = centerY - baseRadius * (1.1f - i * 0.15f);
+        glBegin(GL_LINES);
+        glVertex2f(centerX - baseRadius * (1.0f - i * 0.05f), bandY);
+        glVertex2f(centerX + baseRadius * (1.0f - i * 0.05f), bandY);
+        glEnd();
+    }
+
+    // Enhanced lower body with detailed cylindrical form
+    setColor(mainR, mainG, mainB);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 0.85f, centerY - baseRadius * 0.7f);
+    glVertex2f(centerX + baseRadius * 0.85f, centerY - baseRadius * 0.7f);
+    glVertex2f(centerX + baseRadius * 0.65f, centerY + baseRadius * 0.9f);
+    glVertex2f(centerX - baseRadius * 0.65f, centerY + baseRadius * 0.9f);
+    glEnd();
+
+    // Vertical pleats/folds on robe
+    setColor(shadowR, shadowG, shadowB);
+    glLineWidth(1.5f);
+    for (int i = 0; i < 5; i++) {
+        float pleatX = centerX - baseRadius * 0.6f + i * baseRadius * 0.3f;
+        glBegin(GL_LINES);
+        glVertex2f(pleatX, centerY - baseRadius * 0.5f);
+        glVertex2f(pleatX - baseRadius * 0.1f, centerY + baseRadius * 0.7f);
+        glEnd();
+    }
+
+    // Enhanced mitre with detailed ecclesiastical shape
+    setColor(highlightR, highlightG, highlightB);
+    glBegin(GL_TRIANGLES);
+    glVertex2f(centerX - baseRadius * 0.65f, centerY + baseRadius * 0.9f);
+    glVertex2f(centerX + baseRadius * 0.65f, centerY + baseRadius * 0.9f);
+    glVertex2f(centerX, centerY + baseRadius * 2.4f);
+    glEnd();
+
+    setColor(mainR, mainG, mainB);
+    glBegin(GL_TRIANGLES);
+    glVertex2f(centerX - baseRadius * 0.6f, centerY + baseRadius * 0.95f);
+    glVertex2f(centerX + baseRadius * 0.6f, centerY + baseRadius * 0.95f);
+    glVertex2f(centerX, centerY + baseRadius * 2.3f);
+    glEnd();
+
+    // Mitre decorative seam
+    setColor(highlightR, highlightG, highlightB);
+    glLineWidth(2.5f);
+    glBegin(GL_LINES);
+    glVertex2f(centerX, centerY + baseRadius * 0.95f);
+    glVertex2f(centerX, centerY + baseRadius * 2.3f);
+    glEnd();
+
+    // Ornate mitre decorations
+    setColor(shadowR, shadowG, shadowB);
+    glLineWidth(2.0f);
+    for (int i = 0; i < 4; i++) {
+        float decorY = centerY + baseRadius * (1.2f + i * 0.25f);
+        float decorWidth = baseRadius * (0.5f - i * 0.08f);
+
+        glBegin(GL_LINES);
+        glVertex2f(centerX - decorWidth, decorY);
+        glVertex2f(centerX + decorWidth, decorY);
+        glEnd();
+
+        // Cross patterns on mitre
+        glBegin(GL_LINES);
+        glVertex2f(centerX - decorWidth * 0.3f, decorY - baseRadius * 0.08f);
+        glVertex2f(centerX - decorWidth * 0.3f, decorY + baseRadius * 0.08f);
+        glVertex2f(centerX + decorWidth * 0.3f, decorY - baseRadius * 0.08f);
+        glVertex2f(centerX + decorWidth * 0.3f, decorY + baseRadius * 0.08f);
+        glEnd();
+    }
+
+    // Enhanced mitre jewel/ornament
+    setColor(highlightR, highlightG, highlightB);
+    drawCircle(centerX, centerY + baseRadius * 2.1f, baseRadius * 0.25f, true);
+
+    setColor(shadowR, shadowG, shadowB);
+    drawCircle(centerX, centerY + baseRadius * 2.1f, baseRadius * 0.2f, false);
+
+    // Mitre peak with enhanced cross
+    setColor(highlightR, highlightG, highlightB);
+    drawCircle(centerX, centerY + baseRadius * 2.4f, baseRadius * 0.18f, true);
+
+    // Elaborate cross on peak
+    setColor(shadowR, shadowG, shadowB);
+    glLineWidth(3.0f);
+    glBegin(GL_LINES);
+    // Vertical cross arm
+    glVertex2f(centerX, centerY + baseRadius * 2.2f);
+    glVertex2f(centerX, centerY + baseRadius * 2.7f);
+    // Horizontal cross arm
+    glVertex2f(centerX - baseRadius * 0.15f, centerY + baseRadius * 2.45f);
+    glVertex2f(centerX + baseRadius * 0.15f, centerY + baseRadius * 2.45f);
+    // Short top arm
+    glVertex2f(centerX - baseRadius * 0.08f, centerY + baseRadius * 2.6f);
+    glVertex2f(centerX + baseRadius * 0.08f, centerY + baseRadius * 2.6f);
+    glEnd();
+
+    // Enhanced bishop's slit (distinctive diagonal cut) with depth
+    setColor(shadowR * 0.5f, shadowG * 0.5f, shadowB * 0.5f);
+    glLineWidth(5.0f);
+    glBegin(GL_LINES);
+    glVertex2f(centerX - baseRadius * 0.45f, centerY + baseRadius * 1.3f);
+    glVertex2f(centerX + baseRadius * 0.45f, centerY + baseRadius * 1.9f);
+    glEnd();
+
+    // Slit depth effect
+    setColor(shadowR * 0.8f, shadowG * 0.8f, shadowB * 0.8f);
+    glLineWidth(3.0f);
+    glBegin(GL_LINES);
+    glVertex2f(centerX - baseRadius * 0.42f, centerY + baseRadius * 1.32f);
+    glVertex2f(centerX + baseRadius * 0.42f, centerY + baseRadius * 1.88f);
+    glEnd();
+
+    // Decorative ring around middle body
+    setColor(highlightR, highlightG, highlightB);
+    glLineWidth(2.5f);
+    drawCircle(centerX, centerY + baseRadius * 0.25f, baseRadius * 0.75f, false);
+
+    // Additional ornate details
+    setColor(shadowR, shadowG, shadowB);
+    glLineWidth(1.5f);
+    drawCircle(centerX, centerY + baseRadius * 0.6f, baseRadius * 0.7f, false);
+}
+
+// Draw a knight (horse)
+static void drawKnight(float x, float y, bool isWhite) {
+    float centerX = x + SQUARE_SIZE / 2;
+    float centerY = y + SQUARE_SIZE / 2;
+    float baseRadius = SQUARE_SIZE / 8;
+
+    // Set main piece color
+    setColor(isWhite ? 0.95f : 0.15f, isWhite ? 0.95f : 0.1f, isWhite ? 0.9f : 0.05f);
+
+    // Base platform (like other pieces)
+    drawCircle(centerX, centerY - baseRadius * 1.2f, baseRadius * 1.3f);
+
+    // Base collar
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 1.0f, centerY - baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 1.0f, centerY - baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 0.9f, centerY - baseRadius * 0.8f);
+    glVertex2f(centerX - baseRadius * 0.9f, centerY - baseRadius * 0.8f);
+    glEnd();
+
+    // Horse body/chest (robust and realistic)
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 0.8f, centerY - baseRadius * 0.8f);
+    glVertex2f(centerX + baseRadius * 1.0f, centerY - baseRadius * 0.8f);
+    glVertex2f(centerX + baseRadius * 1.1f, centerY + baseRadius * 0.4f);
+    glVertex2f(centerX - baseRadius * 0.6f, centerY + baseRadius * 0.6f);
+    glEnd();
+
+    // Horse neck (angled forward and upward)
+    setColor(isWhite ? 1.0f : 0.2f, isWhite ? 1.0f : 0.15f, isWhite ? 0.95f : 0.1f);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX + baseRadius * 0.2f, centerY + baseRadius * 0.4f);
+    glVertex2f(centerX + baseRadius * 0.8f, centerY + baseRadius * 0.2f);
+    glVertex2f(centerX + baseRadius * 0.6f, centerY + baseRadius * 1.6f);
+    glVertex2f(centerX + baseRadius * 0.0f, centerY + baseRadius * 1.4f);
+    glEnd();
+
+    // Horse head (profile view, more detailed)
+    glBegin(GL_TRIANGLES);
+    glVertex2f(centerX + baseRadius * 0.0f, centerY + baseRadius * 1.4f);
+    glVertex2f(centerX + baseRadius * 0.6f, centerY + baseRadius * 1.6f);
+    glVertex2f(centerX + baseRadius * 1.0f, centerY + baseRadius * 1.0f);
+    glEnd();
+
+    // Horse muzzle/nose (extended forward)
+    glBegin(GL_TRIANGLES);
+    glVertex2f(centerX + baseRadius * 0.6f, centerY + baseRadius * 1.6f);
+    glVertex2f(centerX + baseRadius * 1.0f, centerY + baseRadius * 1.0f);
+    glVertex2f(centerX + baseRadius * 1.3f, centerY + baseRadius * 1.3f);
+    glEnd();
+
+    // Horse ears (two pointed ears)
+    setColor(isWhite ? 0.9f : 0.18f, isWhite ? 0.9f : 0.12f, isWhite ? 0.85f : 0.08f);
+    glBegin(GL_TRIANGLES);
+    // Left ear
+    glVertex2f(centerX + baseRadius * 0.1f, centerY + baseRadius * 1.7f);
+    glVertex2f(centerX + baseRadius * 0.25f, centerY + baseRadius * 1.7f);
+    glVertex2f(centerX + baseRadius * 0.18f, centerY + baseRadius * 2.1f);
+    glEnd();
+
+    glBegin(GL_TRIANGLES);
+    // Right ear
+    glVertex2f(centerX + baseRadius * 0.35f, centerY + baseRadius * 1.8f);
+    glVertex2f(centerX + baseRadius * 0.5f, centerY + baseRadius * 1.8f);
+    glVertex2f(centerX + baseRadius * 0.43f, centerY + baseRadius * 2.2f);
+    glEnd();
+
+    // Detailed mane (flowing lines)
+    setColor(isWhite ? 0.8f : 0.08f, isWhite ? 0.8f : 0.06f, isWhite ? 0.8f : 0.04f);
+    glLineWidth(3.0f);
+    glBegin(GL_LINES);
+    // Multiple mane strands for realism
+    glVertex2f(centerX - baseRadius * 0.2f, centerY + baseRadius * 1.0f);
+    glVertex2f(centerX - baseRadius * 0.1f, centerY + baseRadius * 1.8f);
+
+    glVertex2f(centerX + baseRadius * 0.0f, centerY + baseRadius * 1.1f);
+    glVertex2f(centerX + baseRadius * 0.1f, centerY + baseRadius * 1.9f);
+
+    glVertex2f(centerX + baseRadius * 0.1f, centerY + baseRadius * 0.9f);
+    glVertex2f(centerX + baseRadius * 0.2f, centerY + baseRadius * 1.7f);
+
+    glVertex2f(centerX + baseRadius * 0.2f, centerY + baseRadius * 0.8f);
+    glVertex2f(centerX + baseRadius * 0.35f, centerY + baseRadius * 1.6f);
+    glEnd();
+
+    // Eye detail (important for character)
+    setColor(isWhite ? 0.1f : 0.9f, isWhite ? 0.1f : 0.9f, isWhite ? 0.1f : 0.9f);
+    drawCircle(centerX + baseRadius * 0.7f, centerY + baseRadius * 1.3f, baseRadius * 0.1f);
+
+    // Nostril detail
+    setColor(isWhite ? 0.3f : 0.0f, isWhite ? 0.3f : 0.0f, isWhite ? 0.3f : 0.0f);
+    drawCircle(centerX + baseRadius * 1.1f, centerY + baseRadius * 1.2f, baseRadius * 0.05f);
+
+    // Bridle detail (decorative line)
+    setColor(isWhite ? 0.6f : 0.05f, isWhite ? 0.6f : 0.05f, isWhite ? 0.6f : 0.05f);
+    glLineWidth(2.0f);
+    glBegin(GL_LINES);
+    glVertex2f(centerX + baseRadius * 0.3f, centerY + baseRadius * 1.5f);
+    glVertex2f(centerX + baseRadius * 0.9f, centerY + baseRadius * 1.1f);
+    glEnd();
+}
+
+// Draw a queen
+static void drawQueen(float x, float y, bool isWhite) {
+    float centerX = x + SQUARE_SIZE / 2;
+    float centerY = y + SQUARE_SIZE / 2;
+    float baseRadius = SQUARE_SIZE / 7;
+
+    // Set main piece color
+    setColor(isWhite ? 0.95f : 0.15f, isWhite ? 0.95f : 0.1f, isWhite ? 0.9f : 0.05f);
+
+    // Base platform (elegant and large)
+    drawCircle(centerX, centerY - baseRadius * 1.2f, baseRadius * 1.5f);
+
+    // Base collar (decorative)
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 1.2f, centerY - baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 1.2f, centerY - baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 1.1f, centerY - baseRadius * 0.8f);
+    glVertex2f(centerX - baseRadius * 1.1f, centerY - baseRadius * 0.8f);
+    glEnd();
+
+    // Lower body (wide and stately)
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 1.0f, centerY - baseRadius * 0.8f);
+    glVertex2f(centerX + baseRadius * 1.0f, centerY - baseRadius * 0.8f);
+    glVertex2f(centerX + baseRadius * 0.9f, centerY + baseRadius * 0.5f);
+    glVertex2f(centerX - baseRadius * 0.9f, centerY + baseRadius * 0.5f);
+    glEnd();
+
+    // Mid section (elegant taper)
+    setColor(isWhite ? 1.0f : 0.2f, isWhite ? 1.0f : 0.15f, isWhite ? 0.95f : 0.1f);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 0.9f, centerY + baseRadius * 0.5f);
+    glVertex2f(centerX + baseRadius * 0.9f, centerY + baseRadius * 0.5f);
+    glVertex2f(centerX + baseRadius * 0.8f, centerY + baseRadius * 1.2f);
+    glVertex2f(centerX - baseRadius * 0.8f, centerY + baseRadius * 1.2f);
+    glEnd();
+
+    // Crown base (wide band)
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 0.8f, centerY + baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 0.8f, centerY + baseRadius * 1.2f);
+    glVertex2f(centerX + baseRadius * 0.8f, centerY + baseRadius * 1.4f);
+    glVertex2f(centerX - baseRadius * 0.8f, centerY + baseRadius * 1.4f);
+    glEnd();
+
+    // Queen's crown (elaborate with 9 points)
+    float crownY = centerY + baseRadius * 1.4f;
+    for (int i = 0; i < 9; i++) {
+        float px = centerX - baseRadius * 0.7f + i * (baseRadius * 1.4f / 8);
+        float height;
+
+        // Create royal crown pattern: high-low-high alternating with center highest
+        if (i == 4) {
+            height = baseRadius * 1.0f; // Center spike (tallest - royal)
+        }
+        else if (i == 2 || i == 6) {
+            height = baseRadius * 0.8f; // Major spikes
+        }
+        else if (i == 1 || i == 3 || i == 5 || i == 7) {
+            height = baseRadius * 0.6f; // Medium spikes
+        }
+        else {
+            height = baseRadius * 0.4f; // Outer spikes
+        }
+
+        glBegin(GL_TRIANGLES);
+        glVertex2f(px - baseRadius / 15, crownY);
+        glVertex2f(px + baseRadius / 15, crownY);
+        glVertex2f(px, crownY + height);
+        glEnd();
+    }
+
+    // Decorative elements (royal ornamentation)
+    setColor(isWhite ? 0.8f : 0.06f, isWhite ? 0.8f : 0.04f, isWhite ? 0.8f : 0.02f);
+
+    // Crown band detail
+    glLineWidth(3.0f);
+    drawCircle(centerX, centerY + baseRadius * 1.3f, baseRadius * 0.75f, false);
+
+    // Body decorative rings (elegant)
+    glLineWidth(2.0f);
+    drawCircle(centerX, centerY + baseRadius * 0.1f, baseRadius * 0.95f, false);
+    drawCircle(centerX, centerY + baseRadius * 0.8f, baseRadius * 0.85f, false);
+
+    // Central jewel on crown (ruby red)
+    setColor(isWhite ? 0.8f : 0.6f, isWhite ? 0.1f : 0.0f, isWhite ? 0.1f : 0.0f);
+    drawCircle(centerX, centerY + baseRadius * 1.7f, baseRadius * 0.12f);
+
+    // Side jewels (emerald green)
+    setColor(isWhite ? 0.1f : 0.0f, isWhite ? 0.7f : 0.4f, isWhite ? 0.1f : 0.0f);
+    drawCircle(centerX - baseRadius * 0.4f, centerY + baseRadius * 1.5f, baseRadius * 0.08f);
+    drawCircle(centerX + baseRadius * 0.4f, centerY + baseRadius * 1.5f, baseRadius * 0.08f);
+
+    // Royal orb detail on highest point
+    setColor(isWhite ? 0.9f : 0.3f, isWhite ? 0.9f : 0.3f, isWhite ? 0.1f : 0.0f);
+    drawCircle(centerX, centerY + baseRadius * 2.4f, baseRadius * 0.1f);
+}
+
+// Draw a king
+static void drawKing(float x, float y, bool isWhite) {
+    float centerX = x + SQUARE_SIZE / 2;
+    float centerY = y + SQUARE_SIZE / 2;
+    float baseRadius = SQUARE_SIZE / 7;
+
+    // Set main piece color
+    setColor(isWhite ? 0.95f : 0.15f, isWhite ? 0.95f : 0.1f, isWhite ? 0.9f : 0.05f);
+
+    // Royal base platform (majestic and largest)
+    drawCircle(centerX, centerY - baseRadius * 1.3f, baseRadius * 1.6f);
+
+    // Base collar with royal detail
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 1.3f, centerY - baseRadius * 1.3f);
+    glVertex2f(centerX + baseRadius * 1.3f, centerY - baseRadius * 1.3f);
+    glVertex2f(centerX + baseRadius * 1.2f, centerY - baseRadius * 0.9f);
+    glVertex2f(centerX - baseRadius * 1.2f, centerY - baseRadius * 0.9f);
+    glEnd();
+
+    // Lower royal body (wide and imposing)
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 1.1f, centerY - baseRadius * 0.9f);
+    glVertex2f(centerX + baseRadius * 1.1f, centerY - baseRadius * 0.9f);
+    glVertex2f(centerX + baseRadius * 1.0f, centerY + baseRadius * 0.3f);
+    glVertex2f(centerX - baseRadius * 1.0f, centerY + baseRadius * 0.3f);
+    glEnd();
+
+    // Mid section (royal taper)
+    setColor(isWhite ? 1.0f : 0.2f, isWhite ? 1.0f : 0.15f, isWhite ? 0.95f : 0.1f);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 1.0f, centerY + baseRadius * 0.3f);
+    glVertex2f(centerX + baseRadius * 1.0f, centerY + baseRadius * 0.3f);
+    glVertex2f(centerX + baseRadius * 0.9f, centerY + baseRadius * 1.0f);
+    glVertex2f(centerX - baseRadius * 0.9f, centerY + baseRadius * 1.0f);
+    glEnd();
+
+    // Upper body (elegant taper to neck)
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 0.9f, centerY + baseRadius * 1.0f);
+    glVertex2f(centerX + baseRadius * 0.9f, centerY + baseRadius * 1.0f);
+    glVertex2f(centerX + baseRadius * 0.8f, centerY + baseRadius * 1.4f);
+    glVertex2f(centerX - baseRadius * 0.8f, centerY + baseRadius * 1.4f);
+    glEnd();
+
+    // Royal crown base (wide and substantial)
+    setColor(isWhite ? 1.0f : 0.25f, isWhite ? 1.0f : 0.2f, isWhite ? 0.9f : 0.15f);
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 0.85f, centerY + baseRadius * 1.4f);
+    glVertex2f(centerX + baseRadius * 0.85f, centerY + baseRadius * 1.4f);
+    glVertex2f(centerX + baseRadius * 0.85f, centerY + baseRadius * 1.6f);
+    glVertex2f(centerX - baseRadius * 0.85f, centerY + baseRadius * 1.6f);
+    glEnd();
+
+    // King's crown band (royal circlet)
+    float crownY = centerY + baseRadius * 1.6f;
+    glBegin(GL_QUADS);
+    glVertex2f(centerX - baseRadius * 0.8f, crownY);
+    glVertex2f(centerX + baseRadius * 0.8f, crownY);
+    glVertex2f(centerX + baseRadius * 0.8f, crownY + baseRadius * 0.3f);
+    glVertex2f(centerX - baseRadius * 0.8f, crownY + baseRadius * 0.3f);
+    glEnd();
+
+    // Crown arches (traditional royal crown with 4 arches)
+    setColor(isWhite ? 0.9f : 0.18f, isWhite ? 0.9f : 0.13f, isWhite ? 0.85f : 0.08f);
+    float archTop = crownY + baseRadius * 0.3f;
+
+    // Front arch
+    for (int i = 0; i <= 10; i++) {
+        float t = i / 10.0f;
+        float x1 = centerX - baseRadius * 0.6f + t * baseRadius * 1.2f;
+        float y1 = archTop + baseRadius * 0.6f * sin(3.14159f * t);
+
+        if (i < 10) {
+            float x2 = centerX - baseRadius * 0.6f + (i + 1) / 10.0f * baseRadius * 1.2f;
+            float y2 = archTop + baseRadius * 0.6f * sin(3.14159f * (i + 1) / 10.0f);
+
+            glLineWidth(4.0f);
+            glBegin(GL_LINES);
+            glVertex2f(x1, y1);
+            glVertex2f(x2, y2);
+            glEnd();
+        }
+    }
+
+    // Side arches (shorter)
+    glLineWidth(3.0f);
+    glBegin(GL_LINES);
+    glVertex2f(centerX - baseRadius * 0.7f, archTop);
+    glVertex2f(centerX, archTop + baseRadius * 0.5f);
+    glEnd();
+    glBegin(GL_LINES);
+    glVertex2f(centerX + baseRadius * 0.7f, archTop);
+    glVertex2f(centerX, archTop + baseRadius * 0.5f);
+    glEnd();
+
+    // Royal orb at crown peak
+    setColor(isWhite ? 1.0f : 0.3f, isWhite ? 0.9f : 0.25f, isWhite ? 0.1f : 0.0f);
+    drawCircle(centerX, archTop + baseRadius * 0.6f, baseRadius * 0.15f);
+
+    // Cross on top of orb (symbol of divine right)
+    setColor(isWhite ? 0.8f : 0.4f, isWhite ? 0.8f : 0.35f, isWhite ? 0.1f : 0.05f);
+    float crossY = archTop + baseRadius * 0.75f;
+    glLineWidth(4.0f);
+    glBegin(GL_LINES);
+    // Vertical line
+    glVertex2f(centerX, crossY);
+    glVertex2f(centerX, crossY + baseRadius * 0.3f);
+    // Horizontal line
+    glVertex2f(centerX - baseRadius * 0.1f, crossY + baseRadius * 0.15f);
+    glVertex2f(centerX + baseRadius * 0.1f, crossY + baseRadius * 0.15f);
+    glEnd();
+
+    // Royal decorative elements
+    setColor(isWhite ? 0.8f : 0.06f, isWhite ? 0.8f : 0.04f, isWhite ? 0.8f : 0.02f);
+
+    // Crown jewels (sapphires)
+    setColor(isWhite ? 0.1f : 0.0f, isWhite ? 0.1f : 0.0f, isWhite ? 0.8f : 0.5f);
+    drawCircle(centerX, crownY + baseRadius * 0.15f, baseRadius * 0.1f);
+    drawCircle(centerX - baseRadius * 0.5f, crownY + baseRadius * 0.15f, baseRadius * 0.08f);
+    drawCircle(centerX + baseRadius * 0.5f, crownY + baseRadius * 0.15f, baseRadius * 0.08f);
+
+    // Body royal decorations (ermine pattern suggestion)
+    setColor(isWhite ? 0.7f : 0.05f, isWhite ? 0.7f : 0.03f, isWhite ? 0.7f : 0.01f);
+    glLineWidth(2.0f);
+    drawCircle(centerX, centerY - baseRadius * 0.1f, baseRadius * 1.05f, false);
+    drawCircle(centerX, centerY + baseRadius * 0.6f, baseRadius * 0.95f, false);
+    drawCircle(centerX, centerY + baseRadius * 1.2f, baseRadius * 0.85f, false);
+
+    // Royal scepter symbols (small decorative crosses)
+    setColor(isWhite ? 0.6f : 0.04f, isWhite ? 0.6f : 0.02f, isWhite ? 0.6f : 0.01f);
+    glLineWidth(2.0f);
+    for (int i = 0; i < 3; i++) {
+        float sy = centerY + baseRadius * (0.2f + i * 0.4f);
+        glBegin(GL_LINES);
+        glVertex2f(centerX - baseRadius * 0.15f, sy);
+        glVertex2f(centerX + baseRadius * 0.15f, sy);
+        glVertex2f(centerX, sy - baseRadius * 0.1f);
+        glVertex2f(centerX, sy + baseRadius * 0.1f);
+        glEnd();
+    }
+}
+
+// Draw a chess piece based on type, vertex by vertex
+static void drawPieceShape(float x, float y, bool isWhite, PieceType type) {
+    // Set piece color
+    if (isWhite) {
+        setColor(0.95f, 0.95f, 0.9f); // Cream white
+    }
+    else {
+        setColor(0.2f, 0.15f, 0.1f); // Dark brown
+    }
+
+    // Draw the piece based on type
+    switch (type) {
+    case PAWN:
+        drawPawn(x, y, isWhite);
+        break;
+    case ROOK:
+        drawRook(x, y, isWhite);
+        break;
+    case KNIGHT:
+        drawKnight(x, y, isWhite);
+        break;
+    case BISHOP:
+        drawBishop(x, y, isWhite);
+        break;
+    case QUEEN:
+        drawQueen(x, y, isWhite);
+        break;
+    case KING:
+        drawKing(x, y, isWhite);
+        break;
+    }
+
+    // Add border/outline
+    if (isWhite) {
+        setColor(0.3f, 0.3f, 0.3f);
+    }
+    else {
+        setColor(0.7f, 0.7f, 0.7f);
+    }
+
+    glLineWidth(1.5f);
+    float centerX = x + SQUARE_SIZE / 2;
+    float centerY = y + SQUARE_SIZE / 2;
+    float radius = SQUARE_SIZE / 5;
+
+    // Simple outline circle for now
+    drawCircle(centerX, centerY, radius, false);
+}
+
+// Display list per piece color and type, drawn at the board origin square
+static GLuint pieceLists[2][6];
+
+// Tessellate every piece shape once into a display list
+void initPieceDisplayLists() {
+    initCircleTable();
+    GLuint base = glGenLists(2 * 6);
+    for (int color = WHITE; color <= BLACK; color++) {
+        for (int type = PAWN; type <= KING; type++) {
+            pieceLists[color][type] = base + color * 6 + type;
+            glNewList(pieceLists[color][type], GL_COMPILE);
+            drawPieceShape(0.0f, 0.0f, color == WHITE, (PieceType)type);
+            glEndList();
+        }
+    }
+}
+
+// Draw a chess piece by replaying its display list at the square's corner
+void drawPiece(float x, float y, bool isWhite, PieceType type) {
+    glPushMatrix();
+    glTranslatef(x, y, 0.0f);
+    glCallList(pieceLists[colorOf(isWhite)][type]);
+    glPopMatrix();
+}
+
+// Draw the pieces of pos standing on the given squares
+void drawChessPieces(const Position& pos, Bitboard squares) {
+    // Draw pieces based on the current board state
+    Bitboard occupied = pos.occupied & squares;
+    while (occupied) {
+        int square = popLsb(occupied);
+        const Piece& piece = pos.squares[square];
+        float x = BOARD_OFFSET + (square % 8) * SQUARE_SIZE;
+        float y = BOARD_OFFSET + (square / 8) * SQUARE_SIZE;
+
+        drawPiece(x, y, piece.isWhite, piece.type);
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef CHESS_RENDER_PIECES_H
+#define CHESS_RENDER_PIECES_H
+
+#include "common.h"
+#include "../engine/position.h"
+
+// Tessellate every piece shape once into a display list (needs a current GL context)
+void initPieceDisplayLists();
+
+// Draw a filled or outlined circle
+void drawCircle(float centerX, float centerY, float radius, bool filled = true);
+
+// Draw a chess piece by replaying its display list at the square's corner
+void drawPiece(float x, float y, bool isWhite, PieceType type);
+
+// Draw the pieces of pos standing on the given squares
+void drawChessPieces(const Position& pos, Bitboard squares);
+
+#endif
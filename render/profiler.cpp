@@ -0,0 +1,125 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+const char* const PROFILE_FIELD_NAMES[PROFILE_FIELD_COUNT] = {
+    "board", "coordinates", "pieces", "ui", "frame", "input_latency"
+};
+
+// Append a frame: fill the slot, then publish it by advancing the write count
+void recordFrame(ProfileRing& ring, const ProfileSample& sample) {
+    unsigned long long frame = ring.written.load(std::memory_order_relaxed);
+    std::atomic<int>* slot = ring.samples[frame & (PROFILE_CAPACITY - 1)];
+
+    // A reader that sees any of these stores also sees the write count reach this frame
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int field = 0; field < PROFILE_FIELD_COUNT; field++) {
+        slot[field].store(sample.values[field], std::memory_order_relaxed);
+    }
+    ring.written.store(frame + 1, std::memory_order_release);
+}
+
+// Copy the newest samples, then drop any the writer may have lapped while we copied
+int snapshotProfile(const ProfileRing& ring, ProfileSample* out, int maxFrames) {
+    if (maxFrames > PROFILE_CAPACITY) maxFrames = PROFILE_CAPACITY;
+    unsigned long long end = ring.written.load(std::memory_order_acquire);
+    unsigned long long begin = end > (unsigned long long)maxFrames ? end - maxFrames : 0;
+
+    for (unsigned long long frame = begin; frame < end; frame++) {
+        const std::atomic<int>* slot = ring.samples[frame & (PROFILE_CAPACITY - 1)];
+        for (int field = 0; field < PROFILE_FIELD_COUNT; field++) {
+            out[frame - begin].values[field] = slot[field].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Frame 'after' may be half written over the slot of frame after - PROFILE_CAPACITY
+    std::atomic_thread_fence(std::memory_order_acquire);
+    unsigned long long after = ring.written.load(std::memory_order_relaxed);
+    unsigned long long firstIntact = after >= PROFILE_CAPACITY ? after - PROFILE_CAPACITY + 1 : 0;
+    if (firstIntact <= begin) {
+        return (int)(end - begin);
+    }
+    if (firstIntact >= end) {
+        return 0;
+    }
+    int dropped = (int)(firstIntact - begin);
+    std::copy(out + dropped, out + (end - begin), out);
+    return (int)(end - firstIntact);
+}
+
+// Summarize frameCount samples; p99 is the value 99% of the frames stay at or below
+void computeProfileStats(const ProfileSample* frames, int frameCount, ProfileStats& stats) {
+    std::vector<int> values;
+    values.reserve(frameCount);
+    stats.frames = frameCount;
+
+    for (int field = 0; field < PROFILE_FIELD_COUNT; field++) {
+        values.clear();
+        long long total = 0;
+        for (int i = 0; i < frameCount; i++) {
+            int value = frames[i].values[field];
+            if (value < 0) continue;
+            values.push_back(value);
+            total += value;
+        }
+
+        stats.count[field] = (int)values.size();
+        if (values.empty()) {
+            stats.minMs[field] = stats.avgMs[field] = stats.p99Ms[field] = 0.0;
+            continue;
+        }
+        size_t rank = (values.size() * 99 + 99) / 100 - 1;
+        std::nth_element(values.begin(), values.begin() + rank, values.end());
+        stats.p99Ms[field] = values[rank] / 1000.0;
+        stats.minMs[field] = *std::min_element(values.begin(), values.end()) / 1000.0;
+        stats.avgMs[field] = total / 1000.0 / values.size();
+    }
+    stats.version++;
+}
+
+// Write one CSV row per frame, in microseconds; frames without input leave latency empty
+bool writeProfileCsv(const char* path, const ProfileSample* frames, int frameCount) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    fprintf(file, "frame");
+    for (int field = 0; field < PROFILE_FIELD_COUNT; field++) {
+        fprintf(file, ",%s_us", PROFILE_FIELD_NAMES[field]);
+    }
+    fprintf(file, "\n");
+
+    for (int i = 0; i < frameCount; i++) {
+        fprintf(file, "%d", i);
+        for (int field = 0; field < PROFILE_FIELD_COUNT; field++) {
+            if (frames[i].values[field] < 0) {
+                fprintf(file, ",");
+            }
+            else {
+                fprintf(file, ",%d", frames[i].values[field]);
+            }
+        }
+        fprintf(file, "\n");
+    }
+    return fclose(file) == 0;
+}
+
+// Write the summary as one JSON object per field, in milliseconds
+bool writeProfileJson(const char* path, const ProfileStats& stats) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    fprintf(file, "{\n  \"frames\": %d,\n", stats.frames);
+    for (int field = 0; field < PROFILE_FIELD_COUNT; field++) {
+        fprintf(file, "  \"%s\": { \"count\": %d, \"min_ms\": %.3f, \"avg_ms\": %.3f, \"p99_ms\": %.3f }%s\n",
+            PROFILE_FIELD_NAMES[field], stats.count[field], stats.minMs[field], stats.avgMs[field],
+            stats.p99Ms[field], field + 1 < PROFILE_FIELD_COUNT ? "," : "");
+    }
+    fprintf(file, "}\n");
+    return fclose(file) == 0;
+}
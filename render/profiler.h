@@ -0,0 +1,58 @@
+#ifndef CHESS_RENDER_PROFILER_H
+#define CHESS_RENDER_PROFILER_H
+
+#include <atomic>
+
+// Per-frame timings, in microseconds
+enum ProfileField {
+    PROFILE_BOARD,         // drawChessBoard
+    PROFILE_COORDINATES,   // drawCoordinates
+    PROFILE_PIECES,        // drawChessPieces
+    PROFILE_UI,            // drawUI and the profiler overlay
+    PROFILE_FRAME,         // Whole display callback up to the buffer swap returning
+    PROFILE_INPUT_LATENCY, // Mouse event to the swap showing it, -1 for frames without input
+    PROFILE_FIELD_COUNT
+};
+
+// Column names used by the overlay and the dumps
+extern const char* const PROFILE_FIELD_NAMES[PROFILE_FIELD_COUNT];
+
+// Number of recent frames kept (a power of two)
+const int PROFILE_CAPACITY = 4096;
+
+// Ring of the most recent frame samples. One thread records; any thread may take
+// snapshots without locks, dropping samples the writer overwrote meanwhile.
+struct ProfileRing {
+    std::atomic<int> samples[PROFILE_CAPACITY][PROFILE_FIELD_COUNT];
+    std::atomic<unsigned long long> written; // Frames recorded so far
+};
+
+// One frame worth of fields, indexed by ProfileField
+struct ProfileSample {
+    int values[PROFILE_FIELD_COUNT];
+};
+
+// Min/avg/p99 of each field over a window of frames, in milliseconds
+struct ProfileStats {
+    int frames;                       // Frames in the window
+    int count[PROFILE_FIELD_COUNT];   // Frames that had the field (input latency is optional)
+    double minMs[PROFILE_FIELD_COUNT];
+    double avgMs[PROFILE_FIELD_COUNT];
+    double p99Ms[PROFILE_FIELD_COUNT];
+    int version;                      // Bumped on every update so cached text can tell it changed
+};
+
+// Append a frame; only one thread may record into a ring
+void recordFrame(ProfileRing& ring, const ProfileSample& sample);
+
+// Copy up to maxFrames of the newest intact samples into out, oldest first; returns the count
+int snapshotProfile(const ProfileRing& ring, ProfileSample* out, int maxFrames);
+
+// Summarize frameCount samples into stats
+void computeProfileStats(const ProfileSample* frames, int frameCount, ProfileStats& stats);
+
+// Write one CSV row per frame, or the summary as JSON; false if the file cannot be written
+bool writeProfileCsv(const char* path, const ProfileSample* frames, int frameCount);
+bool writeProfileJson(const char* path, const ProfileStats& stats);
+
+#endif
@@ -0,0 +1,522 @@
+#include "render.h"
+#include "../engine/bitboard.h"
+#include "../engine/evaluate.h"
+#include "../engine/san.h"
+#include "../engine/search.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// Where glyphs for the atlas come from
+static GlyphSource glyphSource;
+
+// Viewport size in pixels and the world rectangle it shows
+static int viewportWidth = 600, viewportHeight = 600;
+static float viewLeft = -1.0f, viewRight = 1.0f, viewBottom = -1.0f, viewTop = 1.0f;
+
+// Cached text: coordinates change only with the viewport, status lines with the game state
+static TextBatch coordinateBatch = { {}, {}, {}, 0, -1 };
+static TextBatch statusBatch = { {}, {}, {}, 0, -1 };
+static TextBatch profileBatch = { {}, {}, {}, 0, -1 };
+static int profileBatchVersion = -1; // ProfileStats version profileBatch shows
+
+// Piece standing on a board square
+static inline const Piece& pieceAt(const Position& pos, int row, int col) {
+    return pos.squares[squareOf(row, col)];
+}
+
+// Board quads, four corners per square indexed like the engine; built once
+static float boardVertices[64 * 4][2];
+
+// Per-corner square colors, refilled every frame
+static float boardColors[64 * 4][3];
+
+// Build the vertex array holding all 64 board squares
+static void initBoardGeometry() {
+    for (int square = 0; square < 64; square++) {
+        float x = BOARD_OFFSET + (square % 8) * SQUARE_SIZE;
+        float y = BOARD_OFFSET + (square / 8) * SQUARE_SIZE;
+        float* corner = boardVertices[square * 4];
+        corner[0] = x;               corner[1] = y;
+        corner[2] = x + SQUARE_SIZE; corner[3] = y;
+        corner[4] = x + SQUARE_SIZE; corner[5] = y + SQUARE_SIZE;
+        corner[6] = x;               corner[7] = y + SQUARE_SIZE;
+    }
+}
+
+// Color of a square based on selection, legal moves, and highlighting
+static void squareColor(const BoardView& view, int row, int col, float* rgb) {
+    float r, g, b;
+    if (row == view.selectedRow && col == view.selectedCol) {
+        r = 0.9f; g = 0.7f; b = 0.2f; // Golden yellow for selected square
+    }
+    else if (view.legalMoves & squareBit(squareOf(row, col))) {
+        if (pieceAt(*view.position, row, col).type != EMPTY) {
+            r = 0.8f; g = 0.2f; b = 0.2f; // Red for capturable pieces
+        }
+        else {
+            r = 0.2f; g = 0.7f; b = 0.2f; // Green for legal move squares
+        }
+    }
+    else if (row == view.highlightedRow && col == view.highlightedCol) {
+        r = 0.4f; g = 0.6f; b = 0.8f; // Light blue for highlighted square
+    }
+    else if (view.tablebaseHint != 0 && (squareOf(row, col) == moveFrom(view.tablebaseHint) ||
+        squareOf(row, col) == moveTo(view.tablebaseHint))) {
+        r = 0.6f; g = 0.5f; b = 0.8f; // Lavender for the tablebase move
+    }
+    else if ((row + col) % 2 == 0) {
+        r = 0.9f; g = 0.9f; b = 0.9f; // Light gray for white squares
+    }
+    else {
+        r = 0.3f; g = 0.2f; b = 0.1f; // Dark brown for black squares
+    }
+    rgb[0] = r;
+    rgb[1] = g;
+    rgb[2] = b;
+}
+
+// Draw legal move indicators on the selected piece's target squares within squares
+static void drawMoveIndicators(const BoardView& view, Bitboard squares) {
+    Bitboard targets = view.legalMoves & squares;
+    while (targets) {
+        int square = popLsb(targets);
+        float x = BOARD_OFFSET + (square % 8) * SQUARE_SIZE;
+        float y = BOARD_OFFSET + (square / 8) * SQUARE_SIZE;
+
+        if (view.position->squares[square].type != EMPTY) {
+            // Draw capture indicator (corner triangles)
+            setColor(0.9f, 0.1f, 0.1f);
+            glBegin(GL_TRIANGLES);
+            // Top-left corner
+            glVertex2f(x, y + SQUARE_SIZE);
+            glVertex2f(x + SQUARE_SIZE * 0.3f, y + SQUARE_SIZE);
+            glVertex2f(x, y + SQUARE_SIZE * 0.7f);
+            // Bottom-right corner
+            glVertex2f(x + SQUARE_SIZE, y);
+            glVertex2f(x + SQUARE_SIZE * 0.7f, y);
+            glVertex2f(x + SQUARE_SIZE, y + SQUARE_SIZE * 0.3f);
+            glEnd();
+        }
+        else {
+            // Draw move indicator (small circle)
+            setColor(0.1f, 0.5f, 0.1f);
+            drawCircle(x + SQUARE_SIZE / 2, y + SQUARE_SIZE / 2, SQUARE_SIZE * 0.15f);
+        }
+    }
+}
+
+// Issue the board vertex array for a set of squares
+static void drawBoardQuads(Bitboard squares) {
+    if (squares == ~0ULL) {
+        glDrawArrays(GL_QUADS, 0, 64 * 4);
+        return;
+    }
+    while (squares) {
+        glDrawArrays(GL_QUADS, popLsb(squares) * 4, 4);
+    }
+}
+
+// Draw the given board squares from one vertex array: fills first, then borders.
+// The whole board takes two draw calls; a partial redraw one pair per square.
+void drawChessBoard(const BoardView& view, Bitboard squares) {
+    for (int square = 0; square < 64; square++) {
+        float rgb[3];
+        squareColor(view, square / 8, square % 8, rgb);
+        for (int corner = 0; corner < 4; corner++) {
+            memcpy(boardColors[square * 4 + corner], rgb, sizeof(rgb));
+        }
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, boardVertices);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glColorPointer(3, GL_FLOAT, 0, boardColors);
+    drawBoardQuads(squares);
+    glDisableClientState(GL_COLOR_ARRAY);
+
+    // Add border to make squares more distinct
+    setColor(0.1f, 0.1f, 0.1f);
+    glLineWidth(1.0f);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    drawBoardQuads(squares);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    drawMoveIndicators(view, squares);
+}
+
+// Draw board coordinates (A-H, 1-8)
+void drawCoordinates() {
+    if (coordinateBatch.layoutVersion != textLayoutVersion) {
+        coordinateBatch.glyphCount = 0;
+
+        // Column labels (A-H)
+        for (int col = 0; col < BOARD_SIZE; col++) {
+            float x = BOARD_OFFSET + col * SQUARE_SIZE + SQUARE_SIZE / 2 - 0.01f;
+            float y = BOARD_OFFSET - 0.05f;
+            char label[2] = { (char)('A' + col), '\0' };
+            addText(coordinateBatch, x, y, label, FONT_SMALL, 0.0f, 0.0f, 0.0f);
+        }
+
+        // Row labels (1-8)
+        for (int row = 0; row < BOARD_SIZE; row++) {
+            float x = BOARD_OFFSET - 0.05f;
+            float y = BOARD_OFFSET + row * SQUARE_SIZE + SQUARE_SIZE / 2 - 0.01f;
+            char label[2] = { (char)('1' + row), '\0' };
+            addText(coordinateBatch, x, y, label, FONT_SMALL, 0.0f, 0.0f, 0.0f);
+        }
+        coordinateBatch.layoutVersion = textLayoutVersion;
+    }
+    drawTextBatch(coordinateBatch);
+}
+
+// Everything the status text depends on; the text is rebuilt only when this changes
+struct StatusKey {
+    Key positionKey;
+    int fullmoveNumber;
+    int selectedRow, selectedCol;
+    int highlightedRow, highlightedCol;
+    bool thinking;
+    int engineDepth, engineScore;
+    Move tablebaseHint;
+    int tablebaseValue;
+};
+static StatusKey statusKey;
+
+// Static evaluation of the last position shown, so hover and selection changes reuse it
+static bool staticScoreValid = false;
+static Key staticScoreKey;
+static int staticScore;
+
+// Static evaluation from white's side, recomputed only when the position changed
+static int cachedStaticScore(const Position& position) {
+    if (!staticScoreValid || position.key != staticScoreKey) {
+        staticScore = position.whiteToMove ? evaluate(position) : -evaluate(position);
+        staticScoreKey = position.key;
+        staticScoreValid = true;
+    }
+    return staticScore;
+}
+
+// Snapshot of the status inputs, zero-filled so keys compare with memcmp
+static StatusKey statusKeyOf(const BoardView& view) {
+    StatusKey key;
+    memset(&key, 0, sizeof(key));
+    key.positionKey = view.position->key;
+    key.fullmoveNumber = view.position->fullmoveNumber;
+    key.selectedRow = view.selectedRow;
+    key.selectedCol = view.selectedCol;
+    key.highlightedRow = view.highlightedRow;
+    key.highlightedCol = view.highlightedCol;
+    key.thinking = view.engineThinking;
+    key.engineDepth = view.engineDepth;
+    key.engineScore = view.engineScore;
+    key.tablebaseHint = view.tablebaseHint;
+    key.tablebaseValue = view.tablebaseValue;
+    return key;
+}
+
+// Format the status lines and lay them out as glyph quads
+static void buildStatusText(const BoardView& view, TextBatch& batch) {
+    const Position& position = *view.position;
+    int selectedRow = view.selectedRow, selectedCol = view.selectedCol;
+    int highlightedRow = view.highlightedRow, highlightedCol = view.highlightedCol;
+    batch.glyphCount = 0;
+    const char* pieceNames[] = { "Pawn", "Rook", "Knight", "Bishop", "Queen", "King", "Empty" };
+
+    // Title
+    addText(batch, -0.9f, 0.9f, "Chess Game - Turn-Based Mode", FONT_LARGE, 0.0f, 0.0f, 0.0f);
+
+    // Current turn indicator, highlighted in the current player's color
+    char turnInfo[50];
+    sprintf(turnInfo, "Turn: %s (Move #%d)", position.whiteToMove ? "White" : "Black", position.fullmoveNumber);
+    if (position.whiteToMove) {
+        addText(batch, -0.9f, 0.82f, turnInfo, FONT_LARGE, 0.8f, 0.6f, 0.0f); // Gold for white
+    }
+    else {
+        addText(batch, -0.9f, 0.82f, turnInfo, FONT_LARGE, 0.4f, 0.2f, 0.8f); // Purple for black
+    }
+
+    // Instructions
+    addText(batch, -0.9f, 0.75f, "Click to select/move pieces - Green dots: legal moves, Red corners: captures",
+        FONT_SMALL, 0.0f, 0.0f, 0.0f);
+    addText(batch, -0.9f, 0.7f, "ESC: Exit, R: Refresh, C: Clear selection, S: Computer moves now",
+        FONT_SMALL, 0.0f, 0.0f, 0.0f);
+
+    // Show selected square info and piece type
+    if (selectedRow != -1 && selectedCol != -1) {
+        char selectedInfo[100];
+        const char* colorName = pieceAt(position, selectedRow, selectedCol).isWhite ? "White" : "Black";
+
+        if (pieceAt(position, selectedRow, selectedCol).type != EMPTY) {
+            sprintf(selectedInfo, "Selected: %c%d - %s %s",
+                'A' + selectedCol, selectedRow + 1,
+                colorName, pieceNames[pieceAt(position, selectedRow, selectedCol).type]);
+        }
+        else {
+            sprintf(selectedInfo, "Selected: %c%d - Empty square",
+                'A' + selectedCol, selectedRow + 1);
+        }
+        addText(batch, -0.9f, 0.62f, selectedInfo, FONT_SMALL, 0.0f, 0.0f, 0.0f);
+
+        // Count and display legal moves
+        int moveCounter = popCount(view.legalMoves);
+
+        if (moveCounter > 0) {
+            char moveInfo[50];
+            sprintf(moveInfo, "Legal moves available: %d", moveCounter);
+            addText(batch, -0.9f, 0.57f, moveInfo, FONT_SMALL, 0.0f, 0.0f, 0.0f);
+        }
+    }
+
+    // Show the computer's progress while it thinks
+    if (view.engineThinking) {
+        char thinkingInfo[100];
+        int score = view.engineWhite ? view.engineScore : -view.engineScore;
+        if (view.engineDepth == 0) {
+            sprintf(thinkingInfo, "Computer thinking...");
+        }
+        else if (score > MATE_BOUND || score < -MATE_BOUND) {
+            sprintf(thinkingInfo, "Computer thinking... depth %d, %s mates", view.engineDepth, score > 0 ? "White" : "Black");
+        }
+        else {
+            sprintf(thinkingInfo, "Computer thinking... depth %d, eval %+.2f", view.engineDepth, score / 100.0);
+        }
+        addText(batch, 0.1f, 0.62f, thinkingInfo, FONT_SMALL, 0.0f, 0.0f, 0.0f);
+    }
+
+    // Show the tablebase result and its best move
+    if (view.tablebaseHint != 0) {
+        unsigned char value = (unsigned char)view.tablebaseValue;
+        char san[MAX_SAN_LENGTH];
+        moveToSan(position, view.tablebaseHint, san);
+        char tablebaseInfo[100];
+        if (value == TB_DRAW) {
+            sprintf(tablebaseInfo, "Tablebase: draw, hint %s", san);
+        }
+        else {
+            bool whiteWins = isTablebaseWin(value) == position.whiteToMove;
+            int moves = isTablebaseWin(value) ? value : value - TB_LOSS;
+            sprintf(tablebaseInfo, "Tablebase: %s mates in %d, hint %s", whiteWins ? "White" : "Black", moves, san);
+        }
+        addText(batch, 0.1f, 0.57f, tablebaseInfo, FONT_SMALL, 0.0f, 0.0f, 0.0f);
+    }
+
+    // Show the static evaluation from white's side, evaluated once per position
+    char evalInfo[50];
+    sprintf(evalInfo, "Static eval: %+.2f", cachedStaticScore(position) / 100.0);
+    addText(batch, 0.1f, 0.52f, evalInfo, FONT_SMALL, 0.0f, 0.0f, 0.0f);
+
+    // Show highlighted square info
+    if (highlightedRow != -1 && highlightedCol != -1) {
+        char highlightInfo[100];
+
+        if (pieceAt(position, highlightedRow, highlightedCol).type != EMPTY) {
+            const char* colorName = pieceAt(position, highlightedRow, highlightedCol).isWhite ? "White" : "Black";
+            sprintf(highlightInfo, "Hover: %c%d - %s %s",
+                'A' + highlightedCol, highlightedRow + 1,
+                colorName, pieceNames[pieceAt(position, highlightedRow, highlightedCol).type]);
+        }
+        else {
+            sprintf(highlightInfo, "Hover: %c%d - Empty square",
+                'A' + highlightedCol, highlightedRow + 1);
+        }
+        addText(batch, -0.9f, 0.52f, highlightInfo, FONT_SMALL, 0.0f, 0.0f, 0.0f);
+    }
+}
+
+// Draw UI elements and status
+void drawUI(const BoardView& view) {
+    StatusKey key = statusKeyOf(view);
+    if (statusBatch.layoutVersion != textLayoutVersion || memcmp(&key, &statusKey, sizeof(key)) != 0) {
+        statusKey = key;
+        buildStatusText(view, statusBatch);
+        statusBatch.layoutVersion = textLayoutVersion;
+    }
+    drawTextBatch(statusBatch);
+}
+
+// Draw the profiler table below the board, one row per stage
+static void drawProfileOverlay(const ProfileStats& stats) {
+    if (profileBatch.layoutVersion != textLayoutVersion || profileBatchVersion != stats.version) {
+        profileBatch.glyphCount = 0;
+        char line[100];
+        const char* columns[3] = { "min", "avg", "p99" };
+        sprintf(line, "Frame profile, last %d frames (ms)", stats.frames);
+        addText(profileBatch, -0.9f, -0.6f, line, FONT_SMALL, 0.0f, 0.0f, 0.0f);
+        for (int column = 0; column < 3; column++) {
+            addText(profileBatch, -0.2f + column * 0.2f, -0.6f, columns[column], FONT_SMALL, 0.0f, 0.0f, 0.0f);
+        }
+        for (int field = 0; field < PROFILE_FIELD_COUNT; field++) {
+            float y = -0.65f - field * 0.05f;
+            addText(profileBatch, -0.9f, y, PROFILE_FIELD_NAMES[field], FONT_SMALL, 0.0f, 0.0f, 0.0f);
+            if (stats.count[field] == 0) {
+                addText(profileBatch, -0.2f, y, "-", FONT_SMALL, 0.0f, 0.0f, 0.0f);
+                continue;
+            }
+            const double values[3] = { stats.minMs[field], stats.avgMs[field], stats.p99Ms[field] };
+            for (int column = 0; column < 3; column++) {
+                sprintf(line, "%.2f", values[column]);
+                addText(profileBatch, -0.2f + column * 0.2f, y, line, FONT_SMALL, 0.0f, 0.0f, 0.0f);
+            }
+        }
+        profileBatch.layoutVersion = textLayoutVersion;
+        profileBatchVersion = stats.version;
+    }
+    drawTextBatch(profileBatch);
+}
+
+// Set up GL state, board geometry and piece display lists; the glyph atlas is built from
+// glyphs on the first frame
+void initRenderer(const GlyphSource& glyphs) {
+    glClearColor(0.8f, 0.8f, 0.6f, 1.0f); // Light beige background
+    glEnable(GL_POINT_SMOOTH);
+    glEnable(GL_LINE_SMOOTH);
+    glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
+    glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
+
+    glyphSource = glyphs;
+    initBoardGeometry();
+    initPieceDisplayLists();
+}
+
+// Fit the board into a width x height pixel viewport, keeping squares square
+void resizeRenderer(int width, int height) {
+    glViewport(0, 0, width, height);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+
+    if (width <= height) {
+        viewLeft = -1.0f;
+        viewRight = 1.0f;
+        viewBottom = -1.0f * (GLfloat)height / (GLfloat)width;
+        viewTop = 1.0f * (GLfloat)height / (GLfloat)width;
+    }
+    else {
+        viewLeft = -1.0f * (GLfloat)width / (GLfloat)height;
+        viewRight = 1.0f * (GLfloat)width / (GLfloat)height;
+        viewBottom = -1.0f;
+        viewTop = 1.0f;
+    }
+    glOrtho(viewLeft, viewRight, viewBottom, viewTop, -1.0, 1.0);
+    viewportWidth = width;
+    viewportHeight = height;
+    setTextViewport(width, height, viewLeft, viewRight, viewBottom, viewTop);
+
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+}
+
+// Limit drawing to a world-space rectangle, padded by a pixel for edge lines
+static void scissorWorldRect(float left, float bottom, float right, float top) {
+    float scaleX = viewportWidth / (viewRight - viewLeft);
+    float scaleY = viewportHeight / (viewTop - viewBottom);
+    int x0 = (int)floor((left - viewLeft) * scaleX) - 1;
+    int y0 = (int)floor((bottom - viewBottom) * scaleY) - 1;
+    int x1 = (int)ceil((right - viewLeft) * scaleX) + 1;
+    int y1 = (int)ceil((top - viewBottom) * scaleY) + 1;
+    glScissor(x0, y0, x1 - x0, y1 - y0);
+}
+
+// Copy the last presented frame from the front buffer into the back buffer
+static void restoreLastFrame() {
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, viewportWidth, 0, viewportHeight, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glReadBuffer(GL_FRONT);
+    glRasterPos2i(0, 0);
+    glCopyPixels(0, 0, viewportWidth, viewportHeight, GL_COLOR);
+    glReadBuffer(GL_BACK);
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+typedef std::chrono::steady_clock StageClock;
+
+// Add the time since start to a stage of timings and start timing the next stage
+static void endStage(ProfileSample* timings, ProfileField field, StageClock::time_point& start) {
+    if (timings == NULL) {
+        return;
+    }
+    StageClock::time_point now = StageClock::now();
+    timings->values[field] += (int)std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
+    start = now;
+}
+
+// Draw a complete frame into the current draw buffer
+void renderFrame(const BoardView& view, ProfileSample* timings) {
+    if (!isTextAtlasReady()) {
+        initTextAtlas(glyphSource);
+    }
+    StageClock::time_point start = StageClock::now();
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // Draw the chess board
+    drawChessBoard(view, ~0ULL);
+    endStage(timings, PROFILE_BOARD, start);
+
+    // Draw coordinates
+    drawCoordinates();
+    endStage(timings, PROFILE_COORDINATES, start);
+
+    // Draw chess pieces
+    drawChessPieces(*view.position, ~0ULL);
+    endStage(timings, PROFILE_PIECES, start);
+
+    // Draw UI elements
+    drawUI(view);
+    if (view.profile != NULL) {
+        drawProfileOverlay(*view.profile);
+    }
+    endStage(timings, PROFILE_UI, start);
+}
+
+// Repaint only the dirty squares and status text on top of the previous frame
+void renderPartialFrame(const BoardView& view, Bitboard dirtySquares, bool statusDirty, bool copyFrontBuffer,
+    ProfileSample* timings) {
+    if (!isTextAtlasReady()) {
+        renderFrame(view, timings);
+        return;
+    }
+    StageClock::time_point start = StageClock::now();
+    if (copyFrontBuffer) {
+        restoreLastFrame();
+        endStage(timings, PROFILE_BOARD, start);
+    }
+    glEnable(GL_SCISSOR_TEST);
+
+    // Neighbours are redrawn too (clipped) since their borders and pieces may overlap the square
+    Bitboard dirty = dirtySquares;
+    while (dirty) {
+        int square = popLsb(dirty);
+        Bitboard block = squareBit(square) | kingAttacks[square];
+        float x = BOARD_OFFSET + (square % 8) * SQUARE_SIZE;
+        float y = BOARD_OFFSET + (square / 8) * SQUARE_SIZE;
+        scissorWorldRect(x, y, x + SQUARE_SIZE, y + SQUARE_SIZE);
+        drawChessBoard(view, block);
+        endStage(timings, PROFILE_BOARD, start);
+        drawChessPieces(*view.position, block);
+        endStage(timings, PROFILE_PIECES, start);
+    }
+
+    // Status text lives in the band above the board
+    if (statusDirty) {
+        scissorWorldRect(viewLeft, BOARD_OFFSET + BOARD_SIZE * SQUARE_SIZE + 0.01f, viewRight, viewTop);
+        glClear(GL_COLOR_BUFFER_BIT);
+        drawUI(view);
+        endStage(timings, PROFILE_UI, start);
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+}
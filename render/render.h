@@ -0,0 +1,49 @@
+#ifndef CHESS_RENDER_H
+#define CHESS_RENDER_H
+
+#include "common.h"
+#include "pieces.h"
+#include "profiler.h"
+#include "text.h"
+#include "../engine/position.h"
+
+#include <cstddef>
+
+// Everything a frame shows, filled in by the caller
+struct BoardView {
+    const Position* position;
+    Bitboard legalMoves;             // Targets of the selected piece
+    int selectedRow, selectedCol;    // -1 when nothing is selected
+    int highlightedRow, highlightedCol;
+    bool engineThinking;
+    bool engineWhite;                // Side the computer is thinking for
+    int engineDepth, engineScore;    // Last completed iteration, score for engineWhite's side
+    Move tablebaseHint;              // Best move from the endgame tablebases, 0 when not in them
+    int tablebaseValue;              // Tablebase value for the side to move, -1 when not in them
+    const ProfileStats* profile;     // Frame profiler table below the board, NULL hides it
+};
+
+// Set up GL state, board geometry and piece display lists (needs a current GL context).
+// Glyphs for the text atlas come from glyphs.
+void initRenderer(const GlyphSource& glyphs);
+
+// Fit the board into a width x height pixel viewport, keeping squares square
+void resizeRenderer(int width, int height);
+
+// Draw a complete frame into the current draw buffer. If timings is given, the CPU time
+// spent issuing each stage is added to its board, coordinates, pieces and ui fields.
+void renderFrame(const BoardView& view, ProfileSample* timings = NULL);
+
+// Repaint only dirtySquares and, if statusDirty, the status text over the previous frame.
+// With copyFrontBuffer the previous frame is first copied from the front buffer of a
+// double-buffered window; otherwise the draw buffer must still hold it. The profiler
+// table is left as it was.
+void renderPartialFrame(const BoardView& view, Bitboard dirtySquares, bool statusDirty, bool copyFrontBuffer,
+    ProfileSample* timings = NULL);
+
+// Frame stages, in drawing order (pieces come from drawChessPieces)
+void drawChessBoard(const BoardView& view, Bitboard squares);
+void drawCoordinates();
+void drawUI(const BoardView& view);
+
+#endif
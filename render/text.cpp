@@ -0,0 +1,158 @@
+#include "text.h"
+
+#include <cmath>
+
+// Where a glyph sits in the atlas and how far it moves the pen
+struct Glyph {
+    int x, y, width, height; // Atlas cell in pixels
+    int advance;
+};
+
+// Glyph atlas: every printable ASCII character of both fonts rasterized once
+static const int ATLAS_WIDTH = 512, ATLAS_HEIGHT = 256;
+static const int FIRST_GLYPH = 32, LAST_GLYPH = 126;
+static const int GLYPH_PAD = 2; // Cell pixels left of the origin, for glyphs that start left of it
+static GLuint atlasTexture = 0;
+static Glyph glyphs[2][LAST_GLYPH - FIRST_GLYPH + 1];
+static int glyphBaseline[2]; // Cell row of the baseline per font
+
+// Viewport size in pixels and the world rectangle it shows
+static int viewportWidth = 600, viewportHeight = 600;
+static float viewLeft = -1.0f, viewRight = 1.0f, viewBottom = -1.0f, viewTop = 1.0f;
+
+int textLayoutVersion = 0;
+
+// Tell the text layout the viewport size in pixels and the world rectangle it shows
+void setTextViewport(int width, int height, float left, float right, float bottom, float top) {
+    viewportWidth = width;
+    viewportHeight = height;
+    viewLeft = left;
+    viewRight = right;
+    viewBottom = bottom;
+    viewTop = top;
+    textLayoutVersion++;
+}
+
+// Check if the glyph atlas has been built
+bool isTextAtlasReady() {
+    return atlasTexture != 0;
+}
+
+// Rasterize each glyph into the draw buffer and copy it into the atlas, one cell at a time,
+// so the draw buffer only needs to be as large as one glyph cell
+void initTextAtlas(const GlyphSource& source) {
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_INTENSITY8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, NULL);
+
+    // Draw in viewport pixels
+    GLfloat clearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, viewportWidth, 0, viewportHeight, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    glEnable(GL_SCISSOR_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+    int penX = 0, penY = 0;
+    for (int font = FONT_SMALL; font <= FONT_LARGE; font++) {
+        int cellHeight = source.lineHeight((TextFont)font) + 2;
+        glyphBaseline[font] = cellHeight / 4 + 1;
+        if (penX > 0) {
+            penX = 0;
+            penY += source.lineHeight(FONT_SMALL) + 2;
+        }
+
+        for (int c = FIRST_GLYPH; c <= LAST_GLYPH; c++) {
+            Glyph& glyph = glyphs[font][c - FIRST_GLYPH];
+            glyph.advance = source.advance((TextFont)font, c);
+            glyph.width = glyph.advance + 2 * GLYPH_PAD;
+            glyph.height = cellHeight;
+            if (penX + glyph.width > ATLAS_WIDTH) {
+                penX = 0;
+                penY += cellHeight;
+            }
+            glyph.x = penX;
+            glyph.y = penY;
+            penX += glyph.width;
+
+            // Render the glyph white on black in the window corner, then copy the cell
+            glScissor(0, 0, glyph.width, glyph.height);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glColor3f(1.0f, 1.0f, 1.0f);
+            glRasterPos2i(GLYPH_PAD, glyphBaseline[font]);
+            source.drawGlyph((TextFont)font, c);
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, glyph.x, glyph.y, 0, 0, glyph.width, glyph.height);
+        }
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+// Append a string at a world position to a batch, one pixel-aligned quad per glyph
+void addText(TextBatch& batch, float x, float y, const char* text, TextFont font, float r, float g, float b) {
+    float pixelWidth = (viewRight - viewLeft) / viewportWidth;
+    float pixelHeight = (viewTop - viewBottom) / viewportHeight;
+    int penX = (int)floor((x - viewLeft) / pixelWidth + 0.5f);
+    int penY = (int)floor((y - viewBottom) / pixelHeight + 0.5f);
+
+    for (const char* c = text; *c != '\0' && batch.glyphCount < MAX_BATCH_GLYPHS; c++) {
+        if (*c < FIRST_GLYPH || *c > LAST_GLYPH) continue;
+        const Glyph& glyph = glyphs[font][*c - FIRST_GLYPH];
+
+        float left = viewLeft + (penX - GLYPH_PAD) * pixelWidth;
+        float bottom = viewBottom + (penY - glyphBaseline[font]) * pixelHeight;
+        float right = left + glyph.width * pixelWidth;
+        float top = bottom + glyph.height * pixelHeight;
+        float u0 = (float)glyph.x / ATLAS_WIDTH, v0 = (float)glyph.y / ATLAS_HEIGHT;
+        float u1 = (float)(glyph.x + glyph.width) / ATLAS_WIDTH, v1 = (float)(glyph.y + glyph.height) / ATLAS_HEIGHT;
+
+        int v = batch.glyphCount * 4;
+        float corners[4][4] = { { left, bottom, u0, v0 }, { right, bottom, u1, v0 },
+            { right, top, u1, v1 }, { left, top, u0, v1 } };
+        for (int i = 0; i < 4; i++) {
+            batch.vertices[v + i][0] = corners[i][0];
+            batch.vertices[v + i][1] = corners[i][1];
+            batch.texCoords[v + i][0] = corners[i][2];
+            batch.texCoords[v + i][1] = corners[i][3];
+            batch.colors[v + i][0] = r;
+            batch.colors[v + i][1] = g;
+            batch.colors[v + i][2] = b;
+        }
+        batch.glyphCount++;
+        penX += glyph.advance;
+    }
+}
+
+// Draw every string of a batch with a single textured quad list
+void drawTextBatch(const TextBatch& batch) {
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glEnable(GL_TEXTURE_2D);
+    glEnable(GL_ALPHA_TEST);
+    glAlphaFunc(GL_GREATER, 0.5f);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, batch.vertices);
+    glTexCoordPointer(2, GL_FLOAT, 0, batch.texCoords);
+    glColorPointer(3, GL_FLOAT, 0, batch.colors);
+    glDrawArrays(GL_QUADS, 0, batch.glyphCount * 4);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glDisable(GL_ALPHA_TEST);
+    glDisable(GL_TEXTURE_2D);
+}
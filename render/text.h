@@ -0,0 +1,45 @@
+#ifndef CHESS_RENDER_TEXT_H
+#define CHESS_RENDER_TEXT_H
+
+#include "common.h"
+
+// Bitmap fonts used in the window
+enum TextFont { FONT_SMALL, FONT_LARGE };
+
+// Where the atlas gets its glyphs from, e.g. GLUT's bitmap fonts
+struct GlyphSource {
+    int (*lineHeight)(TextFont font);        // Line height in pixels
+    int (*advance)(TextFont font, int c);    // Pen advance in pixels
+    void (*drawGlyph)(TextFont font, int c); // Draw at the current raster position
+};
+
+// Quads for a group of strings, drawn in one call and rebuilt only when their text or the window changes
+const int MAX_BATCH_GLYPHS = 512;
+struct TextBatch {
+    float vertices[MAX_BATCH_GLYPHS * 4][2];
+    float texCoords[MAX_BATCH_GLYPHS * 4][2];
+    float colors[MAX_BATCH_GLYPHS * 4][3];
+    int glyphCount;
+    int layoutVersion; // textLayoutVersion the quads were built for, -1 if never
+};
+
+// Bumped whenever the viewport changes, invalidating every cached text batch
+extern int textLayoutVersion;
+
+// Tell the text layout the viewport size in pixels and the world rectangle it shows
+void setTextViewport(int width, int height, float left, float right, float bottom, float top);
+
+// Check if the glyph atlas has been built
+bool isTextAtlasReady();
+
+// Rasterize each glyph of both fonts into the draw buffer and copy it into the atlas.
+// Overwrites the bottom-left corner of the draw buffer, so call it before drawing a frame.
+void initTextAtlas(const GlyphSource& source);
+
+// Append a string at a world position to a batch, one pixel-aligned quad per glyph
+void addText(TextBatch& batch, float x, float y, const char* text, TextFont font, float r, float g, float b);
+
+// Draw every string of a batch with a single textured quad list
+void drawTextBatch(const TextBatch& batch);
+
+#endif
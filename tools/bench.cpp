@@ -0,0 +1,158 @@
+// Headless search benchmark: measures time-to-depth and nodes per second of the
+// Lazy SMP search for a range of thread counts. Links only the rules engine.
+#include "../engine/engine.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Middlegame and endgame positions searched at every thread count
+static const char* BENCH_FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/R2QKB1R w KQ - 0 8",
+    "2r3k1/pp3ppp/4p3/3n4/3P4/P4N2/1P3PPP/2R3K1 w - - 0 25",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+// Totals of one benchmark run over every position
+struct BenchRun {
+    int threads;
+    long long timeMs;
+    unsigned long long nodes;
+    unsigned long long pawnProbes, pawnHits;
+};
+
+// Search every bench position to depth from an empty table and sum time and nodes
+static BenchRun runBench(const std::vector<const char*>& fens, int depth, int threads, TranspositionTable& tt,
+    const NnueNetwork* network) {
+    BenchRun run;
+    run.threads = threads;
+    run.timeMs = 0;
+    run.nodes = 0;
+    run.pawnProbes = 0;
+    run.pawnHits = 0;
+
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.threads = threads;
+    limits.network = network;
+    for (const char* fen : fens) {
+        Position pos;
+        if (!setFromFen(pos, fen)) {
+            printf("invalid FEN: %s\n", fen);
+            continue;
+        }
+        clearTranspositionTable(tt);
+        std::atomic<bool> stop(false);
+        SearchResult result = searchPosition(pos, NULL, 0, limits, tt, stop);
+        run.timeMs += result.timeMs;
+        run.nodes += result.nodes;
+        run.pawnProbes += result.pawnProbes;
+        run.pawnHits += result.pawnHits;
+    }
+    return run;
+}
+
+// Parse a comma separated thread count list such as "1,2,4,8"
+static std::vector<int> parseThreadList(const char* text) {
+    std::vector<int> counts;
+    while (*text) {
+        int count = atoi(text);
+        if (count > 0) counts.push_back(count);
+        const char* comma = strchr(text, ',');
+        if (comma == NULL) break;
+        text = comma + 1;
+    }
+    return counts;
+}
+
+// bench [--depth N] [--threads 1,2,4,...] [--hash MB] [--fen "<FEN>"] [--nnue FILE [--simd avx2|sse4.1|scalar]]
+int main(int argc, char** argv) {
+    int depth = 10;
+    int hashMb = 64;
+    const char* nnueFile = NULL;
+    const char* simd = NULL;
+    std::vector<int> threadCounts;
+    std::vector<const char*> fens;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            depth = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCounts = parseThreadList(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc) {
+            hashMb = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--fen") == 0 && i + 1 < argc) {
+            fens.push_back(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--nnue") == 0 && i + 1 < argc) {
+            nnueFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--simd") == 0 && i + 1 < argc) {
+            simd = argv[++i];
+        }
+        else {
+            printf("Unknown bench option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (depth < 1) depth = 1;
+
+    // Default: powers of two up to the number of cores
+    if (threadCounts.empty()) {
+        int cores = (int)std::thread::hardware_concurrency();
+        for (int count = 1; count < cores; count *= 2) {
+            threadCounts.push_back(count);
+        }
+        threadCounts.push_back(cores > 1 ? cores : 1);
+    }
+    if (fens.empty()) {
+        fens.assign(BENCH_FENS, BENCH_FENS + sizeof(BENCH_FENS) / sizeof(BENCH_FENS[0]));
+    }
+
+    initEngine();
+    TranspositionTable tt;
+    if (!initTranspositionTable(tt, hashMb)) {
+        printf("Could not allocate a %d MB hash table\n", hashMb);
+        return 1;
+    }
+    NnueNetwork network;
+    if (nnueFile != NULL && !loadNnueNetwork(network, nnueFile)) {
+        printf("Could not load the network %s\n", nnueFile);
+        return 1;
+    }
+    if (simd != NULL && !selectNnueKernels(simd)) {
+        printf("This CPU or build has no %s kernels\n", simd);
+        return 1;
+    }
+
+    printf("Search bench: %d position%s to depth %d, %d MB hash, %s evaluation\n",
+        (int)fens.size(), fens.size() == 1 ? "" : "s", depth, hashMb, nnueFile != NULL ? "NNUE" : "classical");
+    if (nnueFile != NULL) {
+        printf("NNUE kernels: %s\n", nnueKernelName());
+    }
+    printf("threads      time(ms)          nodes        knps   ttd speedup   nps scaling   pawn hits\n");
+
+    BenchRun base;
+    for (size_t i = 0; i < threadCounts.size(); i++) {
+        BenchRun run = runBench(fens, depth, threadCounts[i], tt, network.weights != NULL ? &network : NULL);
+        if (i == 0) base = run;
+
+        double knps = run.nodes / (double)(run.timeMs > 0 ? run.timeMs : 1);
+        double baseKnps = base.nodes / (double)(base.timeMs > 0 ? base.timeMs : 1);
+        printf("%7d  %12lld  %13llu  %10.0f  %10.2fx  %10.2fx  %9.1f%%\n", run.threads, run.timeMs, run.nodes, knps,
+            base.timeMs / (double)(run.timeMs > 0 ? run.timeMs : 1), knps / (baseKnps > 0 ? baseKnps : 1),
+            100.0 * run.pawnHits / (run.pawnProbes > 0 ? run.pawnProbes : 1));
+    }
+
+    freeNnueNetwork(network);
+    freeTranspositionTable(tt);
+    return 0;
+}
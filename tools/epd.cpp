@@ -0,0 +1,254 @@
+// EPD test-suite runner: streams the positions of an EPD file to a pool of worker
+// threads, searches each one and counts how many find the bm move (or avoid the am
+// move). Links only the rules engine.
+#include "../engine/engine.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const int MAX_EPD_LINE = 4096;
+const int MAX_EPD_MOVES = 8;
+
+// One test position with the operations the runner understands
+struct EpdRecord {
+    Position pos;
+    char id[64];
+    Move best[MAX_EPD_MOVES];  // bm: any of these solves the position
+    int bestCount;
+    Move avoid[MAX_EPD_MOVES]; // am: none of these may be played
+    int avoidCount;
+};
+
+// Work shared by the pool: workers take the next line from the file under the lock
+struct EpdRun {
+    FILE* file;
+    std::mutex mutex; // Guards file, lineNumber and the console
+    int lineNumber;
+    SearchLimits limits;
+    int hashMb;
+    bool quiet;
+    std::atomic<int> positions;
+    std::atomic<int> solved;
+    std::atomic<unsigned long long> nodes;
+};
+
+// Read the SAN operands of a bm or am operation into moves; unknown moves are skipped.
+// parseSan stops at the blank after each move, so the operands are not split up first.
+static void parseMoveOperands(const Position& pos, const char* operands, Move* moves, int& count) {
+    for (const char* token = operands + strspn(operands, " \t"); *token != '\0' && count < MAX_EPD_MOVES;
+        token += strspn(token, " \t")) {
+        Move move = parseSan(pos, token);
+        if (move != 0) moves[count++] = move;
+        token += strcspn(token, " \t");
+    }
+}
+
+// Parse "<FEN fields> opcode operands; opcode operands; ..." into record (line is modified)
+static bool parseEpdLine(char* line, EpdRecord& record) {
+    const char* rest = parseFen(record.pos, line);
+    if (rest == NULL) {
+        return false;
+    }
+    record.id[0] = '\0';
+    record.bestCount = 0;
+    record.avoidCount = 0;
+
+    char* operation = line + (rest - line);
+    while (*operation != '\0') {
+        char* end = strchr(operation, ';');
+        if (end != NULL) *end = '\0';
+
+        operation += strspn(operation, " \t");
+        char* operands = operation + strcspn(operation, " \t");
+        if (*operands != '\0') *operands++ = '\0';
+
+        if (strcmp(operation, "bm") == 0) {
+            parseMoveOperands(record.pos, operands, record.best, record.bestCount);
+        }
+        else if (strcmp(operation, "am") == 0) {
+            parseMoveOperands(record.pos, operands, record.avoid, record.avoidCount);
+        }
+        else if (strcmp(operation, "id") == 0) {
+            operands += strspn(operands, " \t\"");
+            operands[strcspn(operands, "\"")] = '\0';
+            snprintf(record.id, sizeof(record.id), "%s", operands);
+        }
+
+        if (end == NULL) break;
+        operation = end + 1;
+    }
+    return record.bestCount > 0 || record.avoidCount > 0;
+}
+
+// Check if a move is in a list
+static bool containsMove(const Move* moves, int count, Move move) {
+    for (int i = 0; i < count; i++) {
+        if (moves[i] == move) return true;
+    }
+    return false;
+}
+
+// Write the SAN of a list of moves separated by spaces
+static void formatMoves(const Position& pos, const Move* moves, int count, char* out, int size) {
+    int length = 0;
+    out[0] = '\0';
+    for (int i = 0; i < count && length + MAX_SAN_LENGTH + 1 < size; i++) {
+        char san[MAX_SAN_LENGTH];
+        moveToSan(pos, moves[i], san);
+        length += snprintf(out + length, size - length, i > 0 ? " %s" : "%s", san);
+    }
+}
+
+// Worker thread body: take lines until the file runs out, searching each position from an empty table
+static void epdWorker(EpdRun* run) {
+    TranspositionTable tt;
+    if (!initTranspositionTable(tt, run->hashMb)) {
+        std::lock_guard<std::mutex> lock(run->mutex);
+        printf("Could not allocate a %d MB hash table\n", run->hashMb);
+        return;
+    }
+
+    char line[MAX_EPD_LINE];
+    EpdRecord record;
+    for (;;) {
+        int lineNumber;
+        {
+            std::lock_guard<std::mutex> lock(run->mutex);
+            if (fgets(line, sizeof(line), run->file) == NULL) break;
+            lineNumber = ++run->lineNumber;
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+        const char* text = line + strspn(line, " \t");
+        if (*text == '\0' || *text == '#') continue;
+
+        if (!parseEpdLine(line, record)) {
+            std::lock_guard<std::mutex> lock(run->mutex);
+            printf("line %d: no position with a bm or am move, skipped\n", lineNumber);
+            continue;
+        }
+
+        clearTranspositionTable(tt);
+        std::atomic<bool> stop(false);
+        SearchResult result = searchPosition(record.pos, NULL, 0, run->limits, tt, stop);
+        bool solved = result.bestMove != 0 &&
+            (record.bestCount == 0 || containsMove(record.best, record.bestCount, result.bestMove)) &&
+            !containsMove(record.avoid, record.avoidCount, result.bestMove);
+
+        run->positions++;
+        run->nodes += result.nodes;
+        if (solved) run->solved++;
+
+        if (!run->quiet) {
+            char played[MAX_SAN_LENGTH] = "-";
+            if (result.bestMove != 0) moveToSan(record.pos, result.bestMove, played);
+            char expected[128];
+            if (record.bestCount > 0) {
+                formatMoves(record.pos, record.best, record.bestCount, expected, sizeof(expected));
+            }
+            else {
+                formatMoves(record.pos, record.avoid, record.avoidCount, expected, sizeof(expected));
+            }
+            std::lock_guard<std::mutex> lock(run->mutex);
+            printf("%5d  %-16s %-8s %s %-16s depth %2d  %6lld ms  %s\n", lineNumber,
+                record.id[0] ? record.id : "-", played, record.bestCount > 0 ? "bm" : "am", expected,
+                result.depth, result.timeMs, solved ? "ok" : "FAIL");
+        }
+    }
+    freeTranspositionTable(tt);
+}
+
+// epd <file.epd> [--depth N] [--movetime MS] [--threads N] [--hash MB] [--quiet]
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    int threads = 0;
+    int hashMb = 16;
+    bool quiet = false;
+    SearchLimits limits;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            limits.depth = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--movetime") == 0 && i + 1 < argc) {
+            limits.moveTimeMs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc) {
+            hashMb = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        }
+        else if (argv[i][0] != '-' && path == NULL) {
+            path = argv[i];
+        }
+        else {
+            printf("Unknown epd option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (path == NULL) {
+        printf("Usage: %s <file.epd> [--depth N] [--movetime MS] [--threads N] [--hash MB] [--quiet]\n", argv[0]);
+        return 2;
+    }
+    if (limits.depth == 0 && limits.moveTimeMs == 0) {
+        limits.moveTimeMs = 1000;
+    }
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+    }
+
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printf("Could not open %s\n", path);
+        return 1;
+    }
+    initEngine();
+
+    // Every worker searches its own position single-threaded with its own table
+    EpdRun run;
+    run.file = file;
+    run.lineNumber = 0;
+    run.limits = limits;
+    run.limits.threads = 1;
+    run.hashMb = hashMb;
+    run.quiet = quiet;
+    run.positions = 0;
+    run.solved = 0;
+    run.nodes = 0;
+
+    if (limits.depth > 0) {
+        printf("EPD %s: depth %d, %d worker%s, %d MB hash each\n", path, limits.depth, threads, threads == 1 ? "" : "s", hashMb);
+    }
+    else {
+        printf("EPD %s: %d ms per position, %d worker%s, %d MB hash each\n", path, limits.moveTimeMs, threads,
+            threads == 1 ? "" : "s", hashMb);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(epdWorker, &run);
+    }
+    epdWorker(&run);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fclose(file);
+
+    int positions = run.positions.load(), solved = run.solved.load();
+    unsigned long long nodes = run.nodes.load();
+    printf("Solved %d of %d (%.1f%%) in %.2f s, %llu nodes, %.0f knps, %.1f positions/s\n", solved, positions,
+        positions > 0 ? 100.0 * solved / positions : 0.0, seconds, nodes,
+        nodes / (seconds > 0 ? seconds : 1) / 1000.0, positions / (seconds > 0 ? seconds : 1));
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Headless perft tool: checks the move generator against published node
+// counts and measures its speed. Links only the rules engine.
+#include "../engine/engine.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// Perft test position with its known node counts by depth
+struct PerftCase {
+    const char* name;
+    const char* fen;
+    int defaultDepth;
+    unsigned long long expected[7]; // expected[d] = nodes at depth d (0 = unknown)
+};
+
+static const PerftCase PERFT_CASES[] = {
+    { "startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5,
+        { 1, 20, 400, 8902, 197281, 4865609, 119060324 } },
+    { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4,
+        { 1, 48, 2039, 97862, 4085603, 193690690, 8031647685ULL } },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5,
+        { 1, 14, 191, 2812, 43238, 674624, 11030083 } },
+    { "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4,
+        { 1, 6, 264, 9467, 422333, 15833292, 706045033 } },
+    { "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4,
+        { 1, 44, 1486, 62379, 2103487, 89941194, 3048196529ULL } },
+    { "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4,
+        { 1, 46, 2079, 89890, 3894594, 164075551, 6923051137ULL } },
+    // En passant squares that no double step could have left: both must be dropped
+    { "ep-empty", "4k3/8/8/3P4/8/8/8/4K3 w - e6 0 1", 5,
+        { 1, 6, 29, 218, 1274, 9906, 59345 } },
+    { "ep-taken", "4k3/8/4p3/3P4/8/8/8/4K3 w - e6 0 1", 5,
+        { 1, 7, 43, 339, 2324, 18430, 130398 } },
+};
+
+// Run perft on one position and print nodes and speed; returns false on a count mismatch or,
+// with check set, on any position whose incremental state differs from a recount
+static bool runPerftCase(const char* name, const char* fen, int depth, unsigned long long expected,
+    int threadCount, bool divide, bool check, unsigned long long& nodes) {
+    Position pos;
+    if (!setFromFen(pos, fen)) {
+        printf("%-10s invalid FEN: %s\n", name, fen);
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<unsigned long long> failures(0);
+    nodes = perftRoot(pos, depth, threadCount, divide, check, &failures);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool passed = (expected == 0 || nodes == expected) && failures.load() == 0;
+    printf("%-10s depth %d  nodes %12llu  time %8.3fs  %8.2f Mnps  %s\n",
+        name, depth, nodes, seconds, nodes / (seconds > 0 ? seconds : 1e-9) / 1e6,
+        expected == 0 && failures.load() == 0 ? "" : (passed ? "OK" : "FAIL"));
+    if (expected != 0 && nodes != expected) {
+        printf("           expected %llu\n", expected);
+    }
+    if (failures.load() != 0) {
+        printf("           %llu positions with a stale key, pawn key, score or phase\n", failures.load());
+    }
+    return passed;
+}
+
+// perft [--depth N] [--threads N] [--divide] [--check] [--fen "<FEN>"]
+int main(int argc, char** argv) {
+    int depth = 0;
+    int threadCount = 1;
+    bool divide = false;
+    bool check = false;
+    const char* fen = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            depth = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCount = atoi(argv[++i]);
+            if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+        }
+        else if (strcmp(argv[i], "--divide") == 0) {
+            divide = true;
+        }
+        else if (strcmp(argv[i], "--check") == 0) {
+            check = true;
+        }
+        else if (strcmp(argv[i], "--fen") == 0 && i + 1 < argc) {
+            fen = argv[++i];
+        }
+        else {
+            printf("Unknown perft option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (threadCount < 1) threadCount = 1;
+
+    initEngine();
+    printf("Perft (%d thread%s%s)\n", threadCount, threadCount == 1 ? "" : "s",
+        check ? ", checking incremental state" : "");
+
+    if (fen != NULL) {
+        unsigned long long nodes;
+        return runPerftCase("custom", fen, depth > 0 ? depth : 1, 0, threadCount, divide, check, nodes) ? 0 : 1;
+    }
+
+    bool allPassed = true;
+    unsigned long long totalNodes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const PerftCase& test : PERFT_CASES) {
+        int caseDepth = depth > 0 ? depth : test.defaultDepth;
+        if (caseDepth > 6) caseDepth = 6;
+        unsigned long long nodes = 0;
+        allPassed &= runPerftCase(test.name, test.fen, caseDepth, test.expected[caseDepth], threadCount, divide,
+            check, nodes);
+        totalNodes += nodes;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("Total: %llu nodes in %.3fs (%.2f Mnps) - %s\n", totalNodes, seconds,
+        totalNodes / (seconds > 0 ? seconds : 1e-9) / 1e6, allPassed ? "all passed" : "FAILED");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+// PGN replay tool: memory-maps a PGN archive, splits it into chunks at game
+// boundaries and replays every game on a pool of threads, checking that each move
+// is legal. Links only the rules engine.
+#include "../engine/engine.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Chunks per thread, so threads that finish early can take over remaining work
+const int CHUNKS_PER_THREAD = 8;
+
+// Totals over the games replayed
+struct PgnTotals {
+    unsigned long long games;
+    unsigned long long illegalGames; // Games with a move that is illegal or unreadable
+    unsigned long long plies;
+    unsigned long long results[4];   // Indexed by PgnResult
+};
+
+// Replay every game that starts in [begin, end); games may run on past end
+static void replayChunk(const MappedFile& file, const char* begin, const char* end, PgnTotals& totals,
+    bool verbose, std::mutex& consoleMutex) {
+    const char* fileEnd = file.data + file.size;
+    const char* c = begin;
+    PgnGame game;
+    for (;;) {
+        while (c < end && (*c == ' ' || *c == '\t' || *c == '\n' || *c == '\r')) c++;
+        if (c >= end) break;
+
+        const char* start = c;
+        c = readPgnGame(c, fileEnd, game);
+        if (c == start) c++; // Stray character: make progress regardless
+
+        totals.games++;
+        totals.plies += game.plies;
+        totals.results[game.result]++;
+        if (game.error != NULL) {
+            totals.illegalGames++;
+            if (verbose) {
+                int length = 0;
+                while (game.error + length < fileEnd && length < 16 && game.error[length] != ' ' &&
+                    game.error[length] != '\n' && game.error[length] != '\r') {
+                    length++;
+                }
+                std::lock_guard<std::mutex> lock(consoleMutex);
+                printf("offset %llu: cannot play \"%.*s\" after %d plies\n",
+                    (unsigned long long)(game.error - file.data), length, game.error, game.plies);
+            }
+        }
+    }
+}
+
+// pgn <file.pgn> [--threads N] [--verbose]
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    int threads = 0;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        }
+        else if (argv[i][0] != '-' && path == NULL) {
+            path = argv[i];
+        }
+        else {
+            printf("Unknown pgn option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (path == NULL) {
+        printf("Usage: %s <file.pgn> [--threads N] [--verbose]\n", argv[0]);
+        return 2;
+    }
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+    }
+
+    MappedFile file;
+    if (!openMappedFile(file, path)) {
+        printf("Could not open %s\n", path);
+        return 1;
+    }
+    initEngine();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Cut the file into equal chunks, each moved forward to the next game start
+    const char* fileEnd = file.data + file.size;
+    int chunkCount = file.size > 0 ? threads * CHUNKS_PER_THREAD : 0;
+    std::vector<const char*> bounds(chunkCount + 1, fileEnd);
+    for (int i = 0; i < chunkCount; i++) {
+        const char* nominal = file.data + file.size / chunkCount * i;
+        bounds[i] = i == 0 ? file.data : findPgnGameStart(nominal, fileEnd);
+    }
+
+    // Each thread claims the next unprocessed chunk and keeps its own totals
+    std::vector<PgnTotals> totals(threads);
+    memset(totals.data(), 0, threads * sizeof(PgnTotals));
+    std::atomic<int> nextChunk(0);
+    std::mutex consoleMutex;
+    auto worker = [&](int id) {
+        for (int i = nextChunk++; i < chunkCount; i = nextChunk++) {
+            if (bounds[i] < bounds[i + 1]) {
+                replayChunk(file, bounds[i], bounds[i + 1], totals[id], verbose, consoleMutex);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (seconds <= 0) seconds = 1e-9;
+
+    PgnTotals sum;
+    memset(&sum, 0, sizeof(sum));
+    for (const PgnTotals& part : totals) {
+        sum.games += part.games;
+        sum.illegalGames += part.illegalGames;
+        sum.plies += part.plies;
+        for (int r = 0; r < 4; r++) sum.results[r] += part.results[r];
+    }
+
+    printf("%llu games (%llu with illegal moves), %llu plies, %d thread%s\n", sum.games, sum.illegalGames, sum.plies,
+        threads, threads == 1 ? "" : "s");
+    printf("Results: %llu white wins, %llu black wins, %llu draws, %llu unfinished\n", sum.results[PGN_WHITE_WINS],
+        sum.results[PGN_BLACK_WINS], sum.results[PGN_DRAW], sum.results[PGN_UNFINISHED]);
+    printf("%.3f s: %.0f games/s, %.2f Mplies/s, %.1f MB/s\n", seconds, sum.games / seconds,
+        sum.plies / seconds / 1e6, file.size / seconds / (1024 * 1024));
+
+    closeMappedFile(file);
+    return sum.illegalGames > 0 ? 1 : 0;
+}
@@ -0,0 +1,330 @@
+// Headless rendering benchmark: draws the board offscreen through Mesa's EGL
+// surfaceless platform (llvmpipe on machines without a GPU or display) and
+// reports frames per second plus per-stage timings. Links the renderer and the
+// rules engine, but not GLUT.
+#include "../engine/engine.h"
+#include "../render/render.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/glext.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Positions replayed by every scenario
+static const char* BENCH_FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+// Stand-in glyphs without GLUT: a solid box per printable character with roughly
+// Helvetica's metrics, so the atlas and text batches cost the same as in the game
+static int boxFontHeight(TextFont font) {
+    return font == FONT_LARGE ? 22 : 15;
+}
+
+static int boxGlyphAdvance(TextFont font, int c) {
+    if (c == ' ') return font == FONT_LARGE ? 5 : 3;
+    return font == FONT_LARGE ? 10 : 7;
+}
+
+static void boxDrawGlyph(TextFont font, int c) {
+    static const GLubyte ONES[32 * 4] = {
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    };
+    int advance = boxGlyphAdvance(font, c);
+    int height = c == ' ' ? 0 : boxFontHeight(font) * 2 / 3 - 2;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBitmap(advance - 1, height, 0, 0, (GLfloat)advance, 0, ONES);
+}
+
+static const GlyphSource BOX_GLYPHS = { boxFontHeight, boxGlyphAdvance, boxDrawGlyph };
+
+// Offscreen GL context: EGL surfaceless display plus a framebuffer object to draw into
+struct OffscreenContext {
+    EGLDisplay display;
+    EGLContext context;
+    GLuint framebuffer;
+    GLuint colorBuffer;
+};
+
+// Create a desktop OpenGL context without any window system and bind a width x height RGBA target
+static bool createOffscreenContext(OffscreenContext& ctx, int width, int height) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    ctx.display = getPlatformDisplay != NULL
+        ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL)
+        : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (ctx.display == EGL_NO_DISPLAY || !eglInitialize(ctx.display, NULL, NULL)) {
+        printf("No EGL display available\n");
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        printf("EGL has no desktop OpenGL support\n");
+        return false;
+    }
+
+    // The surfaceless platform may expose no configs; a config-less context is enough for an FBO
+    const EGLint configAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config = EGL_NO_CONFIG_KHR;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(ctx.display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+        config = EGL_NO_CONFIG_KHR;
+    }
+    ctx.context = eglCreateContext(ctx.display, config, EGL_NO_CONTEXT, NULL);
+    if (ctx.context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(ctx.display, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx.context)) {
+        printf("Could not create a surfaceless OpenGL context\n");
+        return false;
+    }
+
+    // Framebuffer objects are not in the OpenGL 1.1 headers; load them at runtime
+    PFNGLGENFRAMEBUFFERSPROC genFramebuffers = (PFNGLGENFRAMEBUFFERSPROC)eglGetProcAddress("glGenFramebuffers");
+    PFNGLBINDFRAMEBUFFERPROC bindFramebuffer = (PFNGLBINDFRAMEBUFFERPROC)eglGetProcAddress("glBindFramebuffer");
+    PFNGLGENRENDERBUFFERSPROC genRenderbuffers = (PFNGLGENRENDERBUFFERSPROC)eglGetProcAddress("glGenRenderbuffers");
+    PFNGLBINDRENDERBUFFERPROC bindRenderbuffer = (PFNGLBINDRENDERBUFFERPROC)eglGetProcAddress("glBindRenderbuffer");
+    PFNGLRENDERBUFFERSTORAGEPROC renderbufferStorage =
+        (PFNGLRENDERBUFFERSTORAGEPROC)eglGetProcAddress("glRenderbufferStorage");
+    PFNGLFRAMEBUFFERRENDERBUFFERPROC framebufferRenderbuffer =
+        (PFNGLFRAMEBUFFERRENDERBUFFERPROC)eglGetProcAddress("glFramebufferRenderbuffer");
+    PFNGLCHECKFRAMEBUFFERSTATUSPROC checkFramebufferStatus =
+        (PFNGLCHECKFRAMEBUFFERSTATUSPROC)eglGetProcAddress("glCheckFramebufferStatus");
+    if (!genFramebuffers || !bindFramebuffer || !genRenderbuffers || !bindRenderbuffer ||
+        !renderbufferStorage || !framebufferRenderbuffer || !checkFramebufferStatus) {
+        printf("OpenGL framebuffer objects are not available\n");
+        return false;
+    }
+
+    genRenderbuffers(1, &ctx.colorBuffer);
+    bindRenderbuffer(GL_RENDERBUFFER, ctx.colorBuffer);
+    renderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    genFramebuffers(1, &ctx.framebuffer);
+    bindFramebuffer(GL_FRAMEBUFFER, ctx.framebuffer);
+    framebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, ctx.colorBuffer);
+    if (checkFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        printf("Offscreen framebuffer is incomplete\n");
+        return false;
+    }
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    return true;
+}
+
+// One replayed frame: a position with an optional selection and hover square
+struct BenchFrame {
+    Position pos;
+    Bitboard legalMoves;
+    int selectedSquare; // NO_SQUARE when nothing is selected
+    int hoverSquare;
+};
+
+// View of a bench frame for the renderer
+static BoardView viewOf(const BenchFrame& frame) {
+    BoardView view;
+    view.position = &frame.pos;
+    view.legalMoves = frame.legalMoves;
+    view.selectedRow = frame.selectedSquare == NO_SQUARE ? -1 : frame.selectedSquare / 8;
+    view.selectedCol = frame.selectedSquare == NO_SQUARE ? -1 : frame.selectedSquare % 8;
+    view.highlightedRow = frame.hoverSquare == NO_SQUARE ? -1 : frame.hoverSquare / 8;
+    view.highlightedCol = frame.hoverSquare == NO_SQUARE ? -1 : frame.hoverSquare % 8;
+    view.engineThinking = false;
+    view.engineWhite = true;
+    view.engineDepth = 0;
+    view.engineScore = 0;
+    view.tablebaseHint = 0;
+    view.tablebaseValue = -1;
+    view.profile = NULL;
+    return view;
+}
+
+// Every position with no selection and with each piece that has moves selected,
+// hovering over a different square each time
+static std::vector<BenchFrame> buildFrames() {
+    std::vector<BenchFrame> frames;
+    for (const char* fen : BENCH_FENS) {
+        BenchFrame frame;
+        if (!setFromFen(frame.pos, fen)) {
+            printf("invalid FEN: %s\n", fen);
+            continue;
+        }
+        frame.legalMoves = 0;
+        frame.selectedSquare = NO_SQUARE;
+        frame.hoverSquare = NO_SQUARE;
+        frames.push_back(frame);
+
+        MoveList moves;
+        generateMoves(frame.pos, moves);
+        Bitboard movers = 0;
+        for (int i = 0; i < moves.count; i++) {
+            movers |= squareBit(moveFrom(moves.moves[i]));
+        }
+        while (movers) {
+            frame.selectedSquare = popLsb(movers);
+            frame.legalMoves = 0;
+            for (int i = 0; i < moves.count; i++) {
+                if (moveFrom(moves.moves[i]) == frame.selectedSquare) {
+                    frame.legalMoves |= squareBit(moveTo(moves.moves[i]));
+                }
+            }
+            frame.hoverSquare = (frame.selectedSquare * 37 + 11) % 64;
+            frames.push_back(frame);
+        }
+    }
+    return frames;
+}
+
+static double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Write the draw buffer to a binary PPM file
+static bool writeSnapshot(const char* path, int width, int height) {
+    std::vector<unsigned char> pixels(width * height * 3);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return false;
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    for (int row = height - 1; row >= 0; row--) {
+        fwrite(&pixels[row * width * 3], 1, width * 3, file);
+    }
+    fclose(file);
+    return true;
+}
+
+// render_bench [--frames N] [--width W] [--height H] [--snapshot file.ppm]
+int main(int argc, char** argv) {
+    int frameCount = 500;
+    int width = 600, height = 600;
+    const char* snapshot = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frameCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+            height = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            snapshot = argv[++i];
+        }
+        else {
+            printf("Unknown render bench option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (frameCount < 1) frameCount = 1;
+    if (width < 64) width = 64;
+    if (height < 64) height = 64;
+
+    OffscreenContext ctx;
+    if (!createOffscreenContext(ctx, width, height)) {
+        return 1;
+    }
+    initEngine();
+    initRenderer(BOX_GLYPHS);
+    resizeRenderer(width, height);
+
+    std::vector<BenchFrame> frames = buildFrames();
+    printf("Render bench: %dx%d, %d frames over %d scenes, %s\n", width, height, frameCount,
+        (int)frames.size(), (const char*)glGetString(GL_RENDERER));
+
+    // Warm up: builds the glyph atlas and the cached text
+    renderFrame(viewOf(frames[0]));
+    glFinish();
+
+    // Whole frames, the way the game draws after a click or a move
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < frameCount; i++) {
+        renderFrame(viewOf(frames[i % frames.size()]));
+        glFinish();
+    }
+    double fullMs = millisecondsSince(start);
+
+    // The same frames stage by stage, finishing the GL pipeline after each one
+    double stageMs[5] = { 0, 0, 0, 0, 0 };
+    for (int i = 0; i < frameCount; i++) {
+        const BenchFrame& frame = frames[i % frames.size()];
+        BoardView view = viewOf(frame);
+        Clock::time_point stageStart = Clock::now();
+        glClear(GL_COLOR_BUFFER_BIT);
+        glFinish();
+        stageMs[0] += millisecondsSince(stageStart);
+
+        stageStart = Clock::now();
+        drawChessBoard(view, ~0ULL);
+        glFinish();
+        stageMs[1] += millisecondsSince(stageStart);
+
+        stageStart = Clock::now();
+        drawCoordinates();
+        glFinish();
+        stageMs[2] += millisecondsSince(stageStart);
+
+        stageStart = Clock::now();
+        drawChessPieces(frame.pos, ~0ULL);
+        glFinish();
+        stageMs[3] += millisecondsSince(stageStart);
+
+        stageStart = Clock::now();
+        drawUI(view);
+        glFinish();
+        stageMs[4] += millisecondsSince(stageStart);
+    }
+
+    // Hover sweep: the mouse crosses every square, repainting only what changed
+    BenchFrame hover = frames[0];
+    hover.hoverSquare = NO_SQUARE;
+    renderFrame(viewOf(hover));
+    glFinish();
+    start = Clock::now();
+    for (int i = 0; i < frameCount; i++) {
+        int previous = hover.hoverSquare;
+        hover.hoverSquare = i % 64;
+        Bitboard changed = squareBit(hover.hoverSquare) | (previous == NO_SQUARE ? 0 : squareBit(previous));
+        renderPartialFrame(viewOf(hover), changed, true, false);
+        glFinish();
+    }
+    double hoverMs = millisecondsSince(start);
+
+    printf("full frame   %9.1f fps  %8.3f ms/frame\n", frameCount * 1000.0 / fullMs, fullMs / frameCount);
+    const char* stageNames[5] = { "clear", "board", "coordinates", "pieces", "ui" };
+    for (int stage = 0; stage < 5; stage++) {
+        printf("  %-11s              %8.3f ms/frame\n", stageNames[stage], stageMs[stage] / frameCount);
+    }
+    printf("hover sweep  %9.1f fps  %8.3f ms/frame (partial redraw)\n",
+        frameCount * 1000.0 / hoverMs, hoverMs / frameCount);
+
+    if (snapshot != NULL) {
+        renderFrame(viewOf(frames[frames.size() > 1 ? 1 : 0]));
+        glFinish();
+        if (!writeSnapshot(snapshot, width, height)) {
+            printf("Could not write %s\n", snapshot);
+            return 1;
+        }
+        printf("Snapshot written to %s\n", snapshot);
+    }
+
+    eglMakeCurrent(ctx.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(ctx.display, ctx.context);
+    eglTerminate(ctx.display);
+    return 0;
+}
@@ -0,0 +1,446 @@
+// Tablebase generator: solves small endgames by retrograde analysis over every legal
+// placement of their pieces on a pool of threads, and writes one table per material for
+// the engine to probe. Links only the rules engine.
+#include "../engine/engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Positions per chunk a thread claims at a time; a multiple of 64 so chunks own whole bitset words
+const size_t CHUNK_POSITIONS = 1 << 14;
+
+// The tables are written straight from the values the threads fill in
+static_assert(sizeof(std::atomic<unsigned char>) == 1, "values must be laid out as plain bytes");
+
+// One table being built. A position is solved in pass p if it is mated in p plies (even p)
+// or mates in p plies (odd p); after the first pass only positions one move before a
+// position solved in the last pass, or with a capture or promotion whose result becomes
+// known in this pass, are looked at again.
+struct Generation {
+    const TablebaseMaterial* material;
+    const Tablebases* tablebases;                   // Tables that captures and promotions lead into
+    size_t total;                                   // Positions, both sides to move
+    int threads;
+    std::vector<std::atomic<unsigned char>> values; // TB_DRAW until solved
+    std::vector<unsigned char> conversion;          // Next pass a capture or promotion result becomes known in, or 0
+    std::vector<std::atomic<unsigned long long>> candidates; // Bitset of positions to look at this pass
+    std::vector<std::atomic<unsigned long long>> next;       // ... and in the next pass
+    std::atomic<int> lastConversion;                // Last pass any such result becomes known in
+    std::atomic<bool> missingTable;                 // A capture or promotion led to a table not loaded
+};
+
+// Run work(begin, end, totals) over [0, count) in chunks claimed by a pool of threads;
+// returns the sum of what the threads counted
+template <typename Work>
+static unsigned long long parallelChunks(size_t count, int threads, Work work) {
+    std::atomic<size_t> nextChunk(0);
+    std::atomic<unsigned long long> sum(0);
+    auto worker = [&]() {
+        unsigned long long counted = 0;
+        for (size_t begin = nextChunk.fetch_add(CHUNK_POSITIONS); begin < count;
+            begin = nextChunk.fetch_add(CHUNK_POSITIONS)) {
+            counted += work(begin, std::min(begin + CHUNK_POSITIONS, count));
+        }
+        sum += counted;
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    return sum.load();
+}
+
+// Flag a position in a bitset
+static inline void markPosition(std::vector<std::atomic<unsigned long long>>& bits, size_t index) {
+    bits[index >> 6].fetch_or(1ULL << (index & 63), std::memory_order_relaxed);
+}
+
+// Flag every position the side that just moved could have come from (without a capture
+// or promotion, which would have been in another table)
+static void markPredecessors(Generation& generation, Position& pos, std::vector<std::atomic<unsigned long long>>& bits) {
+    bool moverWhite = !pos.whiteToMove;
+    Bitboard movers = pos.colorPieces[colorOf(moverWhite)];
+    while (movers) {
+        int square = popLsb(movers);
+        PieceType type = pos.squares[square].type;
+        Bitboard origins;
+        if (type == PAWN) {
+            int step = moverWhite ? -8 : 8;
+            int back = square + step;
+            origins = 0;
+            if (back >= 8 && back < 56 && pos.squares[back].type == EMPTY) {
+                origins |= squareBit(back);
+                int start = back + step;
+                if ((square >> 3) == (moverWhite ? 3 : 4) && pos.squares[start].type == EMPTY) {
+                    origins |= squareBit(start);
+                }
+            }
+        }
+        else {
+            origins = pieceAttacks(type, square, pos.occupied) & ~pos.occupied;
+        }
+
+        // Step the piece back, index the position, and put it where it was
+        pos.whiteToMove = moverWhite;
+        while (origins) {
+            int origin = popLsb(origins);
+            removePiece(pos, square);
+            putPiece(pos, origin, type, moverWhite);
+            markPosition(bits, tablebaseIndex(*generation.material, pos, false));
+            removePiece(pos, origin);
+            putPiece(pos, square, type, moverWhite);
+        }
+        pos.whiteToMove = !moverWhite;
+    }
+}
+
+// Check if a move leaves the table's material
+static inline bool isConversion(const Position& pos, Move move) {
+    return pos.squares[moveTo(move)].type != EMPTY || moveFlag(move) == PROMOTION;
+}
+
+// Value of the position after a capture or promotion, from the smaller tables
+static unsigned char probeConversion(Generation& generation, const Position& pos, Move move) {
+    Position child = pos;
+    UndoInfo undo;
+    makeMove(child, move, undo);
+    unsigned char value;
+    if (!probeTablebase(*generation.tablebases, child, value)) {
+        generation.missingTable.store(true);
+        return TB_DRAW;
+    }
+    return value;
+}
+
+// What one move of a position is known to lead to by a pass
+struct MoveOutcome {
+    bool lost;      // Into a position lost for the opponent: the mover wins
+    bool won;       // Into a position won for the opponent
+    int nextChange; // Later pass in which a capture or promotion result becomes known, or 0
+};
+
+// Note a capture or promotion result that becomes known in threshold's pass
+static inline void noteThreshold(MoveOutcome& outcome, int threshold, int pass) {
+    if (threshold > pass && (outcome.nextChange == 0 || threshold < outcome.nextChange)) {
+        outcome.nextChange = threshold;
+    }
+}
+
+// Outcome of a move by a pass. A capture or promotion is decided when its smaller table's
+// distance is shorter than the pass. A double step the opponent may take en passant is
+// worth the opponent's best of the stored position (which has no en passant right) and the
+// captures, the way probeTablebase combines them.
+static MoveOutcome moveOutcome(Generation& generation, Position& pos, Move move, int pass) {
+    MoveOutcome outcome = { false, false, 0 };
+    if (isConversion(pos, move)) {
+        unsigned char value = probeConversion(generation, pos, move);
+        if (value != TB_DRAW) noteThreshold(outcome, tablebasePlies(value) + 1, pass);
+        outcome.lost = isTablebaseLoss(value) && tablebasePlies(value) < pass;
+        outcome.won = isTablebaseWin(value) && tablebasePlies(value) < pass;
+        return outcome;
+    }
+
+    UndoInfo undo;
+    makeMove(pos, move, undo);
+    unsigned char stored = generation.values[tablebaseIndex(*generation.material, pos, false)].load(std::memory_order_relaxed);
+    if (!canCaptureEnPassant(pos)) {
+        outcome.lost = isTablebaseLoss(stored);
+        outcome.won = isTablebaseWin(stored);
+    }
+    else {
+        MoveList replies;
+        generateMoves(pos, replies);
+        bool otherMoves = false, capturesLose = true, captureWins = false;
+        for (int i = 0; i < replies.count; i++) {
+            if (moveFlag(replies.moves[i]) != EN_PASSANT) {
+                otherMoves = true;
+                continue;
+            }
+            unsigned char value = probeConversion(generation, pos, replies.moves[i]);
+            if (value != TB_DRAW) noteThreshold(outcome, tablebasePlies(value) + 2, pass);
+            capturesLose &= isTablebaseWin(value) && tablebasePlies(value) + 1 < pass;
+            captureWins |= isTablebaseLoss(value) && tablebasePlies(value) + 1 < pass;
+        }
+        outcome.lost = capturesLose && (!otherMoves || isTablebaseLoss(stored));
+        outcome.won = captureWins || isTablebaseWin(stored);
+    }
+    unmakeMove(pos, move, undo);
+    return outcome;
+}
+
+// First pass: mark illegal positions, solve checkmates, and note the first pass a capture
+// or promotion result becomes known in. Returns the positions mated on the board.
+static unsigned long long initializePositions(Generation& generation, size_t begin, size_t end) {
+    unsigned long long mates = 0;
+    int lastChange = 0;
+    for (size_t index = begin; index < end; index++) {
+        Position pos;
+        if (!setTablebasePosition(*generation.material, index, pos)) {
+            generation.values[index].store(TB_ILLEGAL, std::memory_order_relaxed);
+            continue;
+        }
+        MoveList moves;
+        generateMoves(pos, moves);
+        bool mated = moves.count == 0 && isInCheck(pos);
+        generation.values[index].store(mated ? TB_LOSS : TB_DRAW, std::memory_order_relaxed);
+        if (mated) {
+            markPredecessors(generation, pos, generation.candidates);
+            mates++;
+        }
+
+        // Every threshold of the position: the earliest is kept, later ones are found again
+        // when the position is looked at
+        int firstChange = 0;
+        for (int i = 0; i < moves.count; i++) {
+            MoveOutcome outcome = moveOutcome(generation, pos, moves.moves[i], 0);
+            if (outcome.nextChange != 0 && (firstChange == 0 || outcome.nextChange < firstChange)) {
+                firstChange = outcome.nextChange;
+            }
+            if (outcome.nextChange > lastChange) lastChange = outcome.nextChange;
+        }
+        generation.conversion[index] = (unsigned char)firstChange;
+    }
+
+    int seen = generation.lastConversion.load();
+    while (lastChange > seen && !generation.lastConversion.compare_exchange_weak(seen, lastChange)) {}
+    return mates;
+}
+
+// Try to solve one position in a pass from the outcomes of its moves
+static bool solvePosition(Generation& generation, size_t index, int pass, std::vector<std::atomic<unsigned long long>>& next) {
+    Position pos;
+    setTablebasePosition(*generation.material, index, pos);
+    MoveList moves;
+    generateMoves(pos, moves);
+    if (moves.count == 0) {
+        return false; // Stalemate
+    }
+
+    // Odd passes look for a move into a lost position, even passes for a position whose
+    // every move leads into a won one. Wins are only written in odd passes and losses in
+    // even ones, so what a pass reads never changes under it.
+    bool winning = pass % 2 == 1;
+    bool solved = !winning;
+    int nextChange = 0;
+    for (int i = 0; i < moves.count; i++) {
+        MoveOutcome outcome = moveOutcome(generation, pos, moves.moves[i], pass);
+        if (outcome.nextChange != 0 && (nextChange == 0 || outcome.nextChange < nextChange)) {
+            nextChange = outcome.nextChange;
+        }
+        if (winning && outcome.lost) {
+            solved = true;
+            break;
+        }
+        if (!winning && !outcome.won) {
+            solved = false;
+        }
+    }
+    if (!solved) {
+        generation.conversion[index] = (unsigned char)nextChange;
+        return false;
+    }
+
+    generation.values[index].store((unsigned char)(winning ? (pass + 1) / 2 : TB_LOSS + pass / 2), std::memory_order_relaxed);
+    markPredecessors(generation, pos, next);
+    return true;
+}
+
+// One pass over the flagged positions of [begin, end); returns how many were solved
+static unsigned long long solveChunk(Generation& generation, size_t begin, size_t end, int pass, int lastConversion) {
+    unsigned long long solved = 0;
+    for (size_t word = begin >> 6; word < (end + 63) >> 6; word++) {
+        unsigned long long bits = generation.candidates[word].exchange(0, std::memory_order_relaxed);
+        if (pass <= lastConversion) {
+            for (size_t bit = 0; bit < 64 && (word << 6) + bit < end; bit++) {
+                if (generation.conversion[(word << 6) + bit] == pass) bits |= 1ULL << bit;
+            }
+        }
+        while (bits) {
+            size_t index = (word << 6) + popLsb(bits);
+            if (generation.values[index].load(std::memory_order_relaxed) == TB_DRAW &&
+                solvePosition(generation, index, pass, generation.next)) {
+                solved++;
+            }
+        }
+    }
+    return solved;
+}
+
+// Build one table from the smaller ones already loaded; false if it needs a table that
+// is missing or a mate too long to store
+static bool generateTable(const TablebaseMaterial& material, const Tablebases& tablebases, int threads,
+    std::vector<unsigned char>& out) {
+    Generation generation;
+    generation.material = &material;
+    generation.tablebases = &tablebases;
+    generation.total = 2 * material.size;
+    generation.threads = threads;
+    generation.values = std::vector<std::atomic<unsigned char>>(generation.total);
+    generation.conversion.assign(generation.total, 0);
+    size_t words = (generation.total + 63) / 64;
+    generation.candidates = std::vector<std::atomic<unsigned long long>>(words);
+    generation.next = std::vector<std::atomic<unsigned long long>>(words);
+    generation.lastConversion.store(0);
+    generation.missingTable.store(false);
+
+    parallelChunks(generation.total, threads, [&](size_t begin, size_t end) {
+        return initializePositions(generation, begin, end);
+    });
+    int lastConversion = generation.lastConversion.load();
+
+    for (int pass = 1;; pass++) {
+        unsigned long long solved = parallelChunks(generation.total, threads, [&](size_t begin, size_t end) {
+            return solveChunk(generation, begin, end, pass, lastConversion);
+        });
+        if (solved > 0 && pass > TB_MAX_PLIES) {
+            printf("%s has mates longer than %d moves\n", material.name, TB_MAX_MATE);
+            return false;
+        }
+        if (solved == 0 && pass >= lastConversion) break;
+        std::swap(generation.candidates, generation.next);
+    }
+    if (generation.missingTable.load()) {
+        printf("%s: a capture or promotion leads into a table that is not loaded\n", material.name);
+        return false;
+    }
+
+    out.resize(generation.total);
+    memcpy(out.data(), generation.values.data(), generation.total);
+    return true;
+}
+
+// Print how a table's positions divide into wins, draws and losses, and the longest mate
+// for each side to move, won or lost
+static void printTableSummary(const TablebaseMaterial& material, const std::vector<unsigned char>& values, double seconds) {
+    printf("%-6s %11llu positions  %.2f s\n", material.name, (unsigned long long)values.size(), seconds);
+    for (int side = 0; side < 2; side++) {
+        unsigned long long wins = 0, draws = 0, losses = 0;
+        int longest = 0;
+        size_t longestIndex = 0;
+        for (size_t index = side * material.size; index < (side + 1) * material.size; index++) {
+            unsigned char value = values[index];
+            if (value == TB_ILLEGAL) continue;
+            if (isTablebaseWin(value)) wins++;
+            else if (isTablebaseLoss(value)) losses++;
+            else draws++;
+            int moves = isTablebaseWin(value) ? value : isTablebaseLoss(value) ? value - TB_LOSS : 0;
+            if (moves > longest) {
+                longest = moves;
+                longestIndex = index;
+            }
+        }
+
+        char fen[MAX_FEN_LENGTH] = "-";
+        Position pos;
+        if (longest > 0 && setTablebasePosition(material, longestIndex, pos)) {
+            positionToFen(pos, fen);
+        }
+        printf("       %s to move: %llu wins, %llu draws, %llu losses; longest mate %d: %s\n",
+            side == 0 ? "white" : "black", wins, draws, losses, longest, fen);
+    }
+}
+
+// Generate a table after every table its captures and promotions lead into, skipping
+// those already in the directory
+static bool generateWithDependencies(const char* name, const char* directory, Tablebases& tablebases, int threads) {
+    TablebaseMaterial material;
+    if (!parseTablebaseMaterial(name, material)) {
+        printf("Not a tablebase material: %s\n", name);
+        return false;
+    }
+    for (int slot = 0; slot < TABLEBASE_SLOTS; slot++) {
+        if (tablebases.slots[slot] != NULL && tablebases.slots[slot]->material.key == material.key) return true;
+    }
+
+    // Materials one capture or one promotion away
+    for (int i = 0; i < material.count; i++) {
+        int promotions = material.types[i] == PAWN ? 4 : 0;
+        for (int p = -1; p < promotions; p++) {
+            char smaller[16];
+            char* out = smaller;
+            for (int color = 0; color < 2; color++) {
+                *out++ = 'K';
+                for (int j = 0; j < material.count; j++) {
+                    if (material.isWhite[j] != (color == 0)) continue;
+                    if (j != i) *out++ = material.name[j + 1 + (color == 1 ? 1 : 0)];
+                    else if (p >= 0) *out++ = "QRBN"[p];
+                }
+            }
+            *out = '\0';
+            if (!generateWithDependencies(smaller, directory, tablebases, threads)) return false;
+        }
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<unsigned char> values;
+    if (!generateTable(material, tablebases, threads, values)) {
+        return false;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printTableSummary(material, values, seconds);
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s.tb", directory, material.name);
+    if (!writeTablebase(path, material, values.data()) || !addTablebase(tablebases, path)) {
+        printf("Could not write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+// tbgen [MATERIAL...] [--dir DIR] [--threads N]
+int main(int argc, char** argv) {
+    const char* directory = ".";
+    int threads = 0;
+    std::vector<const char*> names;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            directory = argv[++i];
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        }
+        else if (argv[i][0] != '-') {
+            names.push_back(argv[i]);
+        }
+        else {
+            printf("Usage: %s [MATERIAL...] [--dir DIR] [--threads N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (names.empty()) {
+        static const char* DEFAULT_TABLES[] = { "KQK", "KRK", "KPK", "KBNK" };
+        names.assign(DEFAULT_TABLES, DEFAULT_TABLES + 4);
+    }
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+    }
+
+    initEngine();
+    Tablebases tablebases;
+    openTablebases(tablebases, directory);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool generated = true;
+    for (const char* name : names) {
+        generated = generated && generateWithDependencies(name, directory, tablebases, threads);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%d table%s in %s, %.2f s on %d thread%s\n", tablebases.count, tablebases.count == 1 ? "" : "s",
+        directory, seconds, threads, threads == 1 ? "" : "s");
+
+    closeTablebases(tablebases);
+    return generated ? 0 : 1;
+}
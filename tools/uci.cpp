@@ -0,0 +1,352 @@
+// UCI front-end: drives the search engine over stdin/stdout so match runners and
+// chess GUIs can play it. Links only the rules engine.
+#include "../engine/engine.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+const int DEFAULT_HASH_MB = 64;
+const int MAX_HASH_MB = 65536;
+const int MAX_THREADS = 256;
+
+// Assumed number of moves left when the GUI does not send movestogo
+const int DEFAULT_MOVES_TO_GO = 30;
+
+// Clock time kept back for communication delays, in milliseconds
+const int MOVE_OVERHEAD_MS = 50;
+
+// Engine state between commands. The search runs on its own thread so the command
+// loop keeps reading stdin and can honour "stop" while it thinks.
+struct UciState {
+    Position position;
+    std::vector<Key> history; // Keys of the positions before position, oldest first
+    TranspositionTable tt;
+    OpeningBook book; // Played from when both BookFile and BookKeys are set
+    Tablebases tablebases;
+    NnueNetwork network; // Evaluates in place of the classical evaluation once EvalFile is loaded
+    int hashMb;
+    int threads;
+    std::thread searchThread;
+    std::atomic<bool> stop;
+    std::atomic<bool> infinite; // Hold bestmove back until "stop", even after the search ends
+    bool searching;             // searchThread has not been joined yet
+};
+
+// Print one "info" line per completed iteration (search thread)
+static void printInfo(const SearchInfo& info, void*) {
+    char line[1024];
+    formatSearchInfo(info, line, sizeof(line));
+    printf("%s\n", line);
+}
+
+// Search thread body: search, then announce the best move
+static void searchWorker(UciState* state, SearchLimits limits) {
+    SearchResult result = searchPosition(state->position, state->history.data(), (int)state->history.size(),
+        limits, state->tt, state->stop, printInfo);
+
+    // "go infinite" must not answer before the GUI says stop
+    while (state->infinite.load() && !state->stop.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // The network evaluation does not use the pawn table
+    if (result.pawnProbes > 0) {
+        printf("info string pawn hash hits %.1f%% of %llu probes\n",
+            100.0 * result.pawnHits / result.pawnProbes, result.pawnProbes);
+    }
+
+    char move[6] = "0000";
+    if (result.bestMove != 0) {
+        moveToString(result.bestMove, move);
+    }
+    printf("bestmove %s\n", move);
+}
+
+// Stop a running search and wait for its bestmove
+static void stopSearch(UciState& state) {
+    if (state.searching) {
+        state.stop.store(true);
+        state.searchThread.join();
+        state.searching = false;
+    }
+}
+
+// Find the legal move written in coordinate notation, or 0
+static Move parseMove(const Position& pos, const char* text) {
+    MoveList moves;
+    generateMoves(pos, moves);
+    for (int i = 0; i < moves.count; i++) {
+        char name[6];
+        moveToString(moves.moves[i], name);
+        if (strcmp(name, text) == 0) {
+            return moves.moves[i];
+        }
+    }
+    return 0;
+}
+
+// position [startpos | fen <FEN>] [moves <move>...]
+static void positionCommand(UciState& state, char* args) {
+    char* moves = strstr(args, "moves");
+    if (moves != NULL) {
+        moves[-1] = '\0';
+        moves += strlen("moves");
+    }
+
+    Position pos;
+    if (strncmp(args, "startpos", 8) == 0) {
+        setStartPosition(pos);
+    }
+    else if (strncmp(args, "fen ", 4) == 0) {
+        if (!setFromFen(pos, args + 4)) {
+            printf("info string invalid FEN: %s\n", args + 4);
+            return;
+        }
+    }
+    else {
+        printf("info string expected startpos or fen\n");
+        return;
+    }
+
+    state.position = pos;
+    state.history.clear();
+    for (char* token = moves != NULL ? strtok(moves, " \t") : NULL; token != NULL; token = strtok(NULL, " \t")) {
+        Move move = parseMove(state.position, token);
+        if (move == 0) {
+            printf("info string illegal move %s\n", token);
+            break;
+        }
+        state.history.push_back(state.position.key);
+        UndoInfo undo;
+        makeMove(state.position, move, undo);
+    }
+}
+
+// Thinking time for one move: an even share of the clock plus most of the increment
+static int allocateMoveTime(int timeLeftMs, int incrementMs, int movesToGo) {
+    int moves = movesToGo > 0 ? movesToGo : DEFAULT_MOVES_TO_GO;
+    int time = timeLeftMs / moves + incrementMs * 3 / 4;
+    if (time > timeLeftMs - MOVE_OVERHEAD_MS) time = timeLeftMs - MOVE_OVERHEAD_MS;
+    return time > 1 ? time : 1;
+}
+
+// Parameters of "go" that are followed by a number
+static const char* GO_VALUE_KEYS[] = { "depth", "movetime", "nodes", "wtime", "btime", "winc", "binc", "movestogo" };
+
+// Check if a "go" token takes the next token as its value
+static bool isGoValueKey(const char* token) {
+    for (const char* key : GO_VALUE_KEYS) {
+        if (strcmp(token, key) == 0) return true;
+    }
+    return false;
+}
+
+// go [depth N] [movetime MS] [nodes N] [wtime MS btime MS winc MS binc MS movestogo N] [infinite].
+// Other flags such as ponder are ignored, and so is a searchmoves list.
+static void goCommand(UciState& state, char* args) {
+    SearchLimits limits;
+    limits.threads = state.threads;
+    limits.tablebases = state.tablebases.count > 0 ? &state.tablebases : NULL;
+    limits.network = state.network.weights != NULL ? &state.network : NULL;
+    int timeLeft[2] = { -1, -1 }, increment[2] = { 0, 0 };
+    int movesToGo = 0;
+    bool infinite = false;
+
+    char* token = strtok(args, " \t");
+    while (token != NULL) {
+        // Restricting the root moves is not supported; skip the moves that follow
+        if (strcmp(token, "searchmoves") == 0) {
+            do {
+                token = strtok(NULL, " \t");
+            } while (token != NULL && parseMove(state.position, token) != 0);
+            continue;
+        }
+        if (!isGoValueKey(token)) {
+            if (strcmp(token, "infinite") == 0) infinite = true;
+            token = strtok(NULL, " \t");
+            continue;
+        }
+
+        char* value = strtok(NULL, " \t");
+        if (value == NULL) break;
+        if (strcmp(token, "depth") == 0) limits.depth = atoi(value);
+        else if (strcmp(token, "movetime") == 0) limits.moveTimeMs = atoi(value);
+        else if (strcmp(token, "nodes") == 0) limits.nodes = strtoull(value, NULL, 10);
+        else if (strcmp(token, "wtime") == 0) timeLeft[WHITE] = atoi(value);
+        else if (strcmp(token, "btime") == 0) timeLeft[BLACK] = atoi(value);
+        else if (strcmp(token, "winc") == 0) increment[WHITE] = atoi(value);
+        else if (strcmp(token, "binc") == 0) increment[BLACK] = atoi(value);
+        else if (strcmp(token, "movestogo") == 0) movesToGo = atoi(value);
+        token = strtok(NULL, " \t");
+    }
+
+    // Book moves are answered at once
+    Move bookMove = infinite ? 0 : pickBookMove(state.book, state.position, (unsigned)rand());
+    if (bookMove != 0) {
+        char move[6];
+        moveToString(bookMove, move);
+        printf("info string book move\n");
+        printf("bestmove %s\n", move);
+        return;
+    }
+
+    // A clock only limits the search when nothing more specific was asked for
+    int us = colorOf(state.position.whiteToMove);
+    if (!infinite && limits.moveTimeMs == 0 && timeLeft[us] >= 0) {
+        limits.moveTimeMs = allocateMoveTime(timeLeft[us], increment[us], movesToGo);
+    }
+
+    state.stop.store(false);
+    state.infinite.store(infinite);
+    state.searching = true;
+    state.searchThread = std::thread(searchWorker, &state, limits);
+}
+
+// setoption name <Hash|Threads|Clear Hash|BookFile|BookKeys|TablebasePath|EvalFile> [value N]
+static void setOptionCommand(UciState& state, char* args) {
+    char* name = strstr(args, "name ");
+    if (name == NULL) return;
+    name += 5;
+    char* value = strstr(name, " value ");
+    if (value != NULL) {
+        *value = '\0';
+        value += 7;
+    }
+
+    if (strcmp(name, "Hash") == 0 && value != NULL) {
+        int sizeMb = atoi(value);
+        if (sizeMb < 1) sizeMb = 1;
+        if (sizeMb > MAX_HASH_MB) sizeMb = MAX_HASH_MB;
+        freeTranspositionTable(state.tt);
+        if (!initTranspositionTable(state.tt, sizeMb)) {
+            printf("info string could not allocate %d MB, keeping %d MB\n", sizeMb, state.hashMb);
+            initTranspositionTable(state.tt, state.hashMb);
+            return;
+        }
+        state.hashMb = sizeMb;
+    }
+    else if (strcmp(name, "Threads") == 0 && value != NULL) {
+        int threads = atoi(value);
+        state.threads = threads < 1 ? 1 : threads > MAX_THREADS ? MAX_THREADS : threads;
+    }
+    else if (strcmp(name, "Clear Hash") == 0) {
+        clearTranspositionTable(state.tt);
+    }
+    else if (strcmp(name, "BookFile") == 0 && value != NULL) {
+        if (strcmp(value, "<empty>") == 0) {
+            closeBook(state.book);
+        }
+        else if (!openBook(state.book, value)) {
+            printf("info string could not open the book %s\n", value);
+        }
+    }
+    else if (strcmp(name, "BookKeys") == 0 && value != NULL) {
+        if (!loadPolyglotRandom(state.book, value)) {
+            printf("info string %s does not hold Polyglot's 781 random numbers\n", value);
+        }
+    }
+    else if (strcmp(name, "TablebasePath") == 0 && value != NULL) {
+        closeTablebases(state.tablebases);
+        if (strcmp(value, "<empty>") != 0) {
+            int count = openTablebases(state.tablebases, value);
+            printf("info string found %d tablebase%s in %s\n", count, count == 1 ? "" : "s", value);
+        }
+    }
+    else if (strcmp(name, "EvalFile") == 0 && value != NULL) {
+        if (strcmp(value, "<empty>") == 0) {
+            freeNnueNetwork(state.network);
+        }
+        else if (loadNnueNetwork(state.network, value)) {
+            printf("info string NNUE evaluation from %s, %s kernels\n", value, nnueKernelName());
+        }
+        else {
+            printf("info string %s is not a network file, using the classical evaluation\n", value);
+        }
+    }
+    else {
+        printf("info string unknown option %s\n", name);
+    }
+}
+
+int main() {
+    // Unbuffered so every reply reaches the GUI at once, also through a pipe
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    initEngine();
+    srand((unsigned)time(NULL));
+    static UciState state;
+    setStartPosition(state.position);
+    state.hashMb = DEFAULT_HASH_MB;
+    state.threads = 1;
+    state.stop.store(false);
+    state.infinite.store(false);
+    state.searching = false;
+    if (!initTranspositionTable(state.tt, state.hashMb)) {
+        printf("info string could not allocate a %d MB hash table\n", state.hashMb);
+        return 1;
+    }
+
+    char line[65536];
+    while (fgets(line, sizeof(line), stdin) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char* args = line + strcspn(line, " \t");
+        if (*args != '\0') *args++ = '\0';
+
+        // Commands that only read or stop the search; all others wait for it first
+        if (strcmp(line, "isready") == 0) {
+            printf("readyok\n");
+            continue;
+        }
+        if (strcmp(line, "stop") == 0) {
+            stopSearch(state);
+            continue;
+        }
+        if (line[0] == '\0') {
+            continue;
+        }
+        stopSearch(state);
+
+        if (strcmp(line, "uci") == 0) {
+            printf("id name Chess Board Engine\n");
+            printf("id author Chess Board Project\n");
+            printf("option name Hash type spin default %d min 1 max %d\n", DEFAULT_HASH_MB, MAX_HASH_MB);
+            printf("option name Threads type spin default 1 min 1 max %d\n", MAX_THREADS);
+            printf("option name Clear Hash type button\n");
+            printf("option name BookFile type string default <empty>\n");
+            printf("option name BookKeys type string default <empty>\n");
+            printf("option name TablebasePath type string default <empty>\n");
+            printf("option name EvalFile type string default <empty>\n");
+            printf("uciok\n");
+        }
+        else if (strcmp(line, "ucinewgame") == 0) {
+            clearTranspositionTable(state.tt);
+        }
+        else if (strcmp(line, "position") == 0) {
+            positionCommand(state, args);
+        }
+        else if (strcmp(line, "go") == 0) {
+            goCommand(state, args);
+        }
+        else if (strcmp(line, "setoption") == 0) {
+            setOptionCommand(state, args);
+        }
+        else if (strcmp(line, "quit") == 0) {
+            break;
+        }
+        else {
+            printf("info string unknown command %s\n", line);
+        }
+    }
+
+    stopSearch(state);
+    closeBook(state.book);
+    closeTablebases(state.tablebases);
+    freeNnueNetwork(state.network);
+    freeTranspositionTable(state.tt);
+    return 0;
+}